@@ -0,0 +1,588 @@
+/*
+* Copyright 2025 MTA
+* Author: Ing. Jiri Konecny
+*
+* Host benchmarks of parsing, sensor updates and manager resync over simulated sensor bus.
+*
+* Usage: benchmark [--replay readings.bin] [filter], only benchmarks with filter in name are run.
+* Every benchmark runs until BENCHMARK_MIN_TIME is spent, time and heap allocations per operation are reported.
+* With --replay, simulated bus answers with values of recorded readings log (see recorder.hpp).
+*
+* Usage: benchmark --export readings.bin, recorded readings log is printed as CSV.
+*
+* Usage: benchmark --check, checks (e.g. no heap allocation of steady-state resync) are run,
+* exit code is non-zero if some check failed.
+*/
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "simulated_bus.hpp"
+#include "../libraries/manager.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <thread>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCHMARK_MIN_TIME 200 ///< Minimal measured time of every benchmark in milliseconds.
+#define BENCHMARK_LOG_FILE "benchmark_readings.bin" ///< Temporary readings log of recorder benchmark.
+
+/**********************
+ *     VARIABLES
+ **********************/
+static std::atomic<unsigned long> allocations{0}; ///< Number of heap allocations.
+static const char *filter = nullptr;              ///< Filter of benchmark names.
+static std::vector<ReadingRecord> replay;         ///< Replayed readings, empty for synthetic values.
+
+/*********************
+ *  ALLOCATION COUNTING
+ *********************/
+// Replaced operators pair malloc/free, GCC does not see it when they are inlined into callers
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void *memory = std::malloc(size != 0 ? size : 1);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept {
+    operator delete(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+    operator delete(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept {
+    operator delete(memory);
+}
+
+/*********************
+ *      HELPERS
+ *********************/
+
+/**
+ * @brief Run benchmark body repeatedly until BENCHMARK_MIN_TIME is spent and print time and allocations per operation.
+ *
+ * @param name The benchmark name.
+ * @param body The measured operation.
+ */
+template <typename Body>
+static void runBenchmark(const char *name, Body body) {
+    if (filter != nullptr && std::strstr(name, filter) == nullptr) {
+        return;
+    }
+
+    using namespace std::chrono;
+    body(); // Warm up caches and capacities
+
+    size_t iterations = 0;
+    size_t batch = 1;
+    unsigned long allocated = allocations.load(std::memory_order_relaxed);
+    steady_clock::time_point start = steady_clock::now();
+    steady_clock::duration elapsed;
+    do {
+        for (size_t i = 0; i < batch; i++) {
+            body();
+        }
+        iterations += batch;
+        batch *= 2;
+        elapsed = steady_clock::now() - start;
+    } while (elapsed < milliseconds(BENCHMARK_MIN_TIME));
+    allocated = allocations.load(std::memory_order_relaxed) - allocated;
+
+    flushLogs();
+    double nanos = (double)duration_cast<nanoseconds>(elapsed).count() / (double)iterations;
+    printf("%-44s %10zu iters %14.1f ns/op %10.2f allocs/op\n", name, iterations, nanos, (double)allocated / (double)iterations);
+    fflush(stdout);
+}
+
+/**
+ * @brief Build sensors list as sent in ?INIT response (without '?').
+ */
+static std::string makeSensorsList(size_t count) {
+    SimulatedBusConfig config;
+    config.Sensors = count;
+    return SimulatedBus(config).sensorsList().substr(1);
+}
+
+/**
+ * @brief Build multi-update response of all sensors as sent by the bus.
+ */
+static std::string makeUpdateResponse(size_t count) {
+    SimulatedBusConfig config;
+    config.Sensors = count;
+    SimulatedBus bus(config);
+    bus.sendMessage("?UPDATE");
+    std::string_view frame;
+    bus.pollFrame(frame);
+    return std::string(frame);
+}
+
+/*********************
+ *  MICRO BENCHMARKS
+ *********************/
+static void benchmarkParser() {
+    const std::string source = "?id=12&status=1&rid=7&temperature=21.5&humidity=40";
+    std::string response;
+    runBenchmark("ParseMetadata", [&]() {
+        response.assign(source);
+        SensorMetadata metadata = ParseMetadata(response);
+        (void)metadata;
+    });
+
+    const std::string batch = makeUpdateResponse(100);
+    runBenchmark("splitString/100 sensors", [&]() {
+        std::vector<std::string> parts = splitString(batch, '?');
+        (void)parts;
+    });
+
+    UpdateStreamParser parser;
+    size_t records = 0;
+    runBenchmark("UpdateStreamParser/100 sensors", [&]() {
+        auto count = [&records](const SensorRecord &record) { records += CheckRecord(record); };
+        parser.push(batch, count);
+        parser.finish(count);
+    });
+}
+
+static void benchmarkUpdate() {
+    std::unique_ptr<BaseSensor> adc(createSensor<ADC>("0"));
+    std::unique_ptr<BaseSensor> th(createSensor<TH>("2"));
+    const std::string adcUpdate = "value=255";
+    const std::string thUpdate = "temperature=21.5&humidity=40";
+    runBenchmark("BaseSensor::update/ADC", [&]() {
+        adc->update(adcUpdate);
+    });
+    runBenchmark("BaseSensor::update/TH", [&]() {
+        th->update(thUpdate);
+    });
+
+    // Alternating values raise and clear alarms on every update
+    std::unique_ptr<BaseSensor> alarmed(createSensor<TH>("3"));
+    alarmed->setAlarms("temperature>25~0.5!&humidity<20&temperature/s>1000");
+    const std::string updates[] = {"temperature=21.5&humidity=40", "temperature=30&humidity=10"};
+    size_t next = 0;
+    runBenchmark("BaseSensor::update/TH 3 alarms", [&]() {
+        alarmed->update(updates[next]);
+        next ^= 1;
+    });
+}
+
+/**
+ * @brief Sink counting records, measures recorder without storage.
+ */
+class CountingSink : public ReadingSink
+{
+public:
+    size_t Count = 0; ///< Number of appended records.
+
+    size_t append(const ReadingRecord *records, size_t count) override {
+        (void)records;
+        Count += count;
+        return count;
+    }
+};
+
+static void benchmarkRecorder() {
+    ReadingRecorder recorder;
+    ReadingRecord reading = {};
+    reading.Type = (uint8_t)ProtocolType::INT;
+    CountingSink sink;
+    recorder.setSink(&sink);
+    runBenchmark("ReadingRecorder::record", [&]() {
+        reading.Time++;
+        recorder.record(reading);
+    });
+
+    // Log is reopened when full, so measured time includes only appends into mapped memory
+    remove(BENCHMARK_LOG_FILE);
+    std::unique_ptr<MappedReadingLog> log(new MappedReadingLog(BENCHMARK_LOG_FILE, 1 << 16));
+    if (!log->open()) {
+        printf("Can not open %s, recorder log benchmark skipped.\n", BENCHMARK_LOG_FILE);
+        return;
+    }
+    ReadingRecord batch[RECORDER_BUFFER_SIZE] = {};
+    runBenchmark("MappedReadingLog::append/batch", [&]() {
+        if (log->append(batch, RECORDER_BUFFER_SIZE) != RECORDER_BUFFER_SIZE) {
+            log.reset();
+            remove(BENCHMARK_LOG_FILE);
+            log.reset(new MappedReadingLog(BENCHMARK_LOG_FILE, 1 << 16));
+            log->open();
+        }
+    });
+    log.reset();
+    remove(BENCHMARK_LOG_FILE);
+}
+
+static void benchmarkFactory() {
+    alignas(std::max_align_t) static unsigned char pool[SENSOR_POOL_SIZE];
+    MemoryArena arena(pool, sizeof(pool));
+    std::vector<BaseSensor*> sensors;
+    for (size_t count : {100, 1000}) {
+        const std::string list = makeSensorsList(count);
+        runBenchmark(("createSensorList/" + std::to_string(count) + " sensors").c_str(), [&]() {
+            createSensorList(sensors, list, &arena);
+            for (BaseSensor *sensor : sensors) {
+                destroySensor(sensor, &arena);
+            }
+            sensors.clear();
+            arena.reset();
+        });
+    }
+}
+
+/*********************
+ *  MACRO BENCHMARKS
+ *********************/
+
+/**
+ * @brief Benchmark blocking resync of all sensors over simulated bus.
+ */
+static void benchmarkResync(const char *name, const SimulatedBusConfig &config) {
+    SimulatedBus bus(config);
+    bus.loadReplay(replay);
+    setDefaultMessenger(&bus);
+    std::unique_ptr<SensorManager> manager(new SensorManager());
+    manager->init(true);
+    runBenchmark(name, [&]() {
+        manager->resync();
+        bus.flush(); // Drop late (timed out) responses
+    });
+    manager->erase();
+    setDefaultMessenger(nullptr);
+}
+
+/**
+ * @brief Benchmark asynchronous resync (requestResync + process loop) over simulated bus.
+ */
+static void benchmarkAsyncResync(const char *name, const SimulatedBusConfig &config) {
+    SimulatedBus bus(config);
+    bus.loadReplay(replay);
+    setDefaultMessenger(&bus);
+    std::unique_ptr<SensorManager> manager(new SensorManager());
+    manager->init(true);
+    runBenchmark(name, [&]() {
+        manager->requestResync();
+        while (manager->isSyncPending()) {
+            manager->process();
+        }
+    });
+    manager->erase();
+    setDefaultMessenger(nullptr);
+}
+
+/**
+ * @brief Benchmark on-demand sync of one sensor served from cache and forced refresh over simulated bus.
+ */
+static void benchmarkSync() {
+    SimulatedBusConfig config;
+    config.Sensors = 10;
+    SimulatedBus bus(config);
+    bus.loadReplay(replay);
+    setDefaultMessenger(&bus);
+    std::unique_ptr<SensorManager> manager(new SensorManager());
+    manager->init(true);
+    BaseSensor *sensor = manager->getSensor(std::string_view("0"));
+    sensor->setFreshTTL(60000); // Stays fresh for whole benchmark
+    manager->refresh("0");
+    unsigned long requests = bus.requests();
+    runBenchmark("SensorManager::sync/fresh", [&]() {
+        manager->sync("0");
+    });
+    if (bus.requests() != requests) {
+        printf("Fresh syncs sent %lu requests!\n", bus.requests() - requests);
+    }
+    runBenchmark("SensorManager::refresh", [&]() {
+        manager->refresh("0");
+    });
+    manager->erase();
+    setDefaultMessenger(nullptr);
+
+    // Dead sensor is marked OFFLINE after SENSOR_MAX_FAILURES, then only probed in background
+    config.DeadSensors = 1;
+    SimulatedBus dead(config);
+    setDefaultMessenger(&dead);
+    manager.reset(new SensorManager());
+    manager->init(true);
+    manager->refresh("0");
+    runBenchmark("SensorManager::refresh/dead sensor", [&]() {
+        manager->refresh("9");
+    });
+    manager->erase();
+    setDefaultMessenger(nullptr);
+}
+
+static void benchmarkManager() {
+    SimulatedBusConfig config;
+    config.Sensors = 10;
+    benchmarkResync("SensorManager::resync/10 sensors", config);
+    config.Sensors = 100;
+    benchmarkResync("SensorManager::resync/100 sensors", config);
+    config.Sensors = 1000;
+    benchmarkResync("SensorManager::resync/1000 sensors", config);
+
+    config.Sensors = 100;
+    config.CorruptPercent = 5;
+    benchmarkResync("SensorManager::resync/100 sensors corrupt", config);
+
+    config.Sensors = 10;
+    config.CorruptPercent = 0;
+    config.Latency = 1;
+    config.Jitter = 2;
+    benchmarkAsyncResync("SensorManager::process/10 sensors 1-3 ms", config);
+    config.DeadSensors = 1;
+    benchmarkAsyncResync("SensorManager::process/10 sensors 1 dead", config);
+    config.DeadSensors = 0;
+
+    benchmarkSync();
+}
+
+/*********************
+ *      CHECKS
+ *********************/
+
+/**
+ * @brief Check that operation does not allocate once capacities are warmed up.
+ *
+ * @param name The check name.
+ * @param body The checked operation.
+ * @return true if no heap allocation was made.
+ */
+template <typename Body>
+static bool checkNoAllocations(const char *name, Body body) {
+    for (size_t i = 0; i < 4; i++) {
+        body(); // Warm up capacities
+    }
+    unsigned long allocated = allocations.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < 100; i++) {
+        body();
+    }
+    allocated = allocations.load(std::memory_order_relaxed) - allocated;
+    printf("%-44s %s (%lu allocations)\n", name, (allocated == 0) ? "OK" : "FAILED", allocated);
+    return allocated == 0;
+}
+
+/**
+ * @brief Check that steady-state synchronization over allocation-free loopback makes no heap allocation.
+ */
+static bool checkSteadyStateAllocations() {
+    LoopbackBus bus(100);
+    setDefaultMessenger(&bus);
+    std::unique_ptr<SensorManager> manager(new SensorManager());
+    manager->init(true);
+
+    bool ok = true;
+    ok &= checkNoAllocations("SensorManager::resync/full", [&]() {
+        manager->resync(true);
+    });
+    ok &= checkNoAllocations("SensorManager::resync/delta", [&]() {
+        manager->resync();
+    });
+    for (size_t i = 0; i < 100; i++) {
+        manager->setPollInterval(std::to_string(i), 0); // Every sensor is due on every poll
+    }
+    ok &= checkNoAllocations("SensorManager::poll", [&]() {
+        manager->poll();
+    });
+    ok &= checkNoAllocations("SensorManager::requestResync+process", [&]() {
+        manager->requestResync();
+        while (manager->isSyncPending()) {
+            manager->process();
+        }
+    });
+    manager->erase();
+    setDefaultMessenger(nullptr);
+    return ok;
+}
+
+/**
+ * @brief ADC sensor counting its updates by tryUpdate() override.
+ */
+class CountingADC : public ADC {
+    public:
+        size_t Updates = 0; ///< Number of updates.
+
+        CountingADC(std::string uid) : ADC(std::move(uid)) {}
+
+        ErrorCode tryUpdate(std::string_view upd) override {
+            Updates++;
+            return ADC::tryUpdate(upd);
+        }
+};
+
+/**
+ * @brief Check that updates of all paths reach overridden tryUpdate().
+ */
+static bool checkUpdateOverride() {
+    CountingADC sensor("0");
+    sensor.update("value=1");
+    SensorRecord record;
+    record.UID = "0";
+    record.ID = sensor.ID;
+    record.Status = "OK";
+    record.Data = "value=2";
+    sensor.applyValues(record);
+    SensorMetadata metadata;
+    metadata.UID = "0";
+    metadata.ID = sensor.ID;
+    metadata.Status = "OK";
+    metadata.Data = "value=3";
+    sensor.applyValues(metadata);
+    bool ok = sensor.Updates == 3;
+    printf("%-44s %s (%zu of 3 updates)\n", "BaseSensor::tryUpdate override", ok ? "OK" : "FAILED", sensor.Updates);
+    return ok;
+}
+
+/**
+ * @brief Check that reader thread never gets torn snapshot, while writer thread publishes updates.
+ *
+ * Writer sets temperature and humidity to the same value in every update, so consistent snapshot has them equal.
+ */
+static bool checkSnapshotConsistency() {
+    const size_t updates = 200000;
+    TH sensor("2");
+    std::atomic<bool> started{false}, done{false};
+    size_t reads = 0, torn = 0, regressions = 0;
+
+    std::thread reader([&]() {
+        SensorSnapshot snapshot;
+        uint32_t version = 0;
+        started.store(true, std::memory_order_release);
+        while (!done.load(std::memory_order_acquire)) {
+            uint32_t current = sensor.getSnapshotVersion();
+            if (!sensor.readSnapshot(snapshot)) {
+                continue;
+            }
+            reads++;
+            if (snapshot.ValuesCount != 2 || snapshot.Values[0] != snapshot.Values[1]) {
+                torn++;
+            }
+            if (current < version) {
+                regressions++;
+            }
+            version = current;
+        }
+    });
+
+    while (!started.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    char data[64];
+    SensorRecord record;
+    record.UID = "2";
+    record.ID = sensor.ID;
+    record.Status = "OK";
+    for (size_t i = 0; i < updates; i++) {
+        int length = snprintf(data, sizeof(data), "temperature=%zu&humidity=%zu", i % 1000, i % 1000);
+        record.Data = std::string_view(data, (size_t)length);
+        sensor.applyValues(record);
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    bool ok = torn == 0 && regressions == 0 && reads > 0 && sensor.getSnapshotVersion() == updates;
+    printf("%-44s %s (%zu reads, %zu torn, %zu version regressions)\n", "BaseSensor::publish/concurrent reader",
+        ok ? "OK" : "FAILED", reads, torn, regressions);
+    return ok;
+}
+
+/**
+ * @brief Run checks, exit code is non-zero if some check failed.
+ */
+static int runChecks() {
+    bool ok = true;
+    ok &= checkSteadyStateAllocations();
+    ok &= checkUpdateOverride();
+    ok &= checkSnapshotConsistency();
+    flushLogs();
+    printf(ok ? "All checks passed.\n" : "Some checks FAILED!\n");
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Print recorded readings log as CSV.
+ */
+static int exportReadings(const char *path) {
+    ReadingLogReader reader;
+    if (!reader.open(path)) {
+        fprintf(stderr, "%s is not readings log!\n", path);
+        return 1;
+    }
+    static const char *types[] = {"int", "double", "float"};
+    printf("time,sensor,slot,type,value\n");
+    ReadingRecord reading;
+    while (reader.next(reading)) {
+        printf("%lu,%u,%u,%s,%.17g\n", (unsigned long)reading.Time, (unsigned int)reading.Sensor, (unsigned int)reading.Slot,
+               (reading.Type < 3) ? types[reading.Type] : "unknown", reading.asDouble());
+    }
+    return 0;
+}
+
+/**
+ * @brief Load readings log replayed by simulated bus.
+ */
+static bool loadReplay(const char *path) {
+    ReadingLogReader reader;
+    if (!reader.open(path)) {
+        fprintf(stderr, "%s is not readings log!\n", path);
+        return false;
+    }
+    replay.clear();
+    replay.reserve(reader.size());
+    ReadingRecord reading;
+    while (reader.next(reading)) {
+        replay.push_back(reading);
+    }
+    printf("Replaying %zu readings of %s\n", replay.size(), path);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    int arg = 1;
+    if (argc > 1 && std::strcmp(argv[1], "--check") == 0) {
+        return runChecks();
+    }
+    if (argc > 2 && std::strcmp(argv[1], "--export") == 0) {
+        return exportReadings(argv[2]);
+    }
+    if (argc > 2 && std::strcmp(argv[1], "--replay") == 0) {
+        if (!loadReplay(argv[2])) {
+            return 1;
+        }
+        arg = 3;
+    }
+    if (argc > arg) {
+        filter = argv[arg];
+    }
+
+    benchmarkParser();
+    benchmarkUpdate();
+    benchmarkRecorder();
+    benchmarkFactory();
+    benchmarkManager();
+    flushLogs();
+    return 0;
+}
@@ -0,0 +1,264 @@
+/*
+* Copyright 2025 MTA
+* Author: Ing. Jiri Konecny
+*/
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "simulated_bus.hpp"
+#include "../libraries/helpers.hpp" ///< For getMillis, KeyValueTokenizer, parseNumber
+#include "../libraries/sensors.hpp" ///< For ADC and TH schema of replayed values
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+uint32_t SimulatedBus::nextRandom() {
+    // xorshift32, deterministic for given seed
+    Random ^= Random << 13;
+    Random ^= Random >> 17;
+    Random ^= Random << 5;
+    return Random;
+}
+
+void SimulatedBus::respond(std::string &&data) {
+    unsigned long delay = Config.Latency;
+    if (Config.Jitter > 0) {
+        delay += nextRandom() % (Config.Jitter + 1);
+    }
+    if (Config.CorruptPercent > 0 && data.size() > 1 && nextRandom() % 100 < Config.CorruptPercent) {
+        data[1 + nextRandom() % (data.size() - 1)] = '~';
+    }
+    Queue.push_back(Response{getMillis() + delay, std::move(data)});
+}
+
+std::string SimulatedBus::sensorsList() const {
+    std::string list = "?";
+    for (size_t i = 0; i < Config.Sensors; i++) {
+        if (i > 0) {
+            list += '&';
+        }
+        list += std::to_string(i);
+        list += (i % 3 == 2) ? ":TH" : ":ADC";
+    }
+    return list;
+}
+
+/**
+ * @brief Get schema of simulated sensor (same order as sensorsList()).
+ */
+static const SensorSchema& schemaOf(size_t index) {
+    return (index % 3 == 2) ? TH::Schema : ADC::Schema;
+}
+
+size_t SimulatedBus::loadReplay(const std::vector<ReadingRecord> &readings) {
+    Replay.assign(Config.Sensors, std::vector<ReadingRecord>());
+    ReplayCursor.assign(Config.Sensors, 0);
+    size_t count = 0;
+    for (const ReadingRecord &reading : readings) {
+        if (reading.Sensor < Config.Sensors && reading.Slot < schemaOf(reading.Sensor).ValuesCount) {
+            Replay[reading.Sensor].push_back(reading);
+            count++;
+        }
+    }
+    return count;
+}
+
+bool SimulatedBus::appendReplay(std::string &out, size_t index) {
+    if (index >= Replay.size() || Replay[index].empty()) {
+        return false;
+    }
+
+    const std::vector<ReadingRecord> &readings = Replay[index];
+    const SensorSchema &schema = schemaOf(index);
+    size_t &cursor = ReplayCursor[index];
+    if (cursor >= readings.size()) {
+        cursor = 0;
+    }
+    char buffer[SENSOR_PARAM_TEXT_SIZE + 32];
+    snprintf(buffer, sizeof(buffer), "id=%u&status=1", (unsigned int)index);
+    out += buffer;
+    // One update is readings with the same timestamp, repeated slot starts next update
+    uint32_t time = readings[cursor].Time;
+    uint64_t slots = 0;
+    while (cursor < readings.size() && readings[cursor].Time == time && (slots & (1ull << (readings[cursor].Slot % 64))) == 0) {
+        const ReadingRecord &reading = readings[cursor++];
+        slots |= 1ull << (reading.Slot % 64);
+        const char *key = schema.Values[reading.Slot].Key;
+        switch ((ProtocolType)reading.Type) {
+        case ProtocolType::INT:
+            snprintf(buffer, sizeof(buffer), "&%s=%d", key, (int)reading.Value.Int);
+            break;
+        case ProtocolType::FLOAT:
+            snprintf(buffer, sizeof(buffer), "&%s=%.9g", key, (double)reading.Value.Float);
+            break;
+        default:
+            snprintf(buffer, sizeof(buffer), "&%s=%.17g", key, reading.Value.Double);
+            break;
+        }
+        out += buffer;
+    }
+    return true;
+}
+
+void SimulatedBus::appendSensor(std::string &out, size_t index) {
+    if (appendReplay(out, index)) {
+        return;
+    }
+    char buffer[96];
+    if (index % 3 == 2) {
+        snprintf(buffer, sizeof(buffer), "id=%u&status=1&temperature=%.1f&humidity=%u", (unsigned int)index,
+                 20.0 + (double)((Sequence + index) % 100) / 10.0, (unsigned int)((Sequence + index) % 100));
+    } else {
+        snprintf(buffer, sizeof(buffer), "id=%u&status=1&value=%u", (unsigned int)index,
+                 (unsigned int)((Sequence * 31 + index * 7) % 4096));
+    }
+    out += buffer;
+}
+
+void SimulatedBus::handleUpdate(std::string_view request) {
+    std::string_view ids;
+    std::string_view rid;
+    KeyValueTokenizer tokenizer(request, '&');
+    KeyValuePair pair;
+    while (tokenizer.next(pair)) {
+        if (pair.Key == "id") {
+            ids = pair.Value;
+        } else if (pair.Key == "rid") {
+            rid = pair.Value;
+        }
+    }
+    Sequence++;
+
+    // Single sensor request of asynchronous resync, matched by request ID
+    if (!rid.empty()) {
+        unsigned long index = 0;
+        if (!parseNumber(ids, index) || index + Config.DeadSensors >= Config.Sensors) {
+            return;
+        }
+        std::string response = "?";
+        appendSensor(response, index);
+        response += "&rid=";
+        response += rid;
+        respond(std::move(response));
+        return;
+    }
+
+    // Multi-update of listed (or all) sensors, full state is sent (device without delta support)
+    std::string response = "?seq=" + std::to_string(Sequence);
+    if (ids.empty()) {
+        for (size_t i = 0; i + Config.DeadSensors < Config.Sensors; i++) {
+            response += '?';
+            appendSensor(response, i);
+        }
+    } else {
+        KeyValueTokenizer list(ids, ',');
+        while (list.next(pair)) {
+            unsigned long index = 0;
+            if (parseNumber(pair.Key, index) && index + Config.DeadSensors < Config.Sensors) {
+                response += '?';
+                appendSensor(response, index);
+            }
+        }
+    }
+    respond(std::move(response));
+}
+
+void SimulatedBus::sendMessage(const std::string &message) {
+    Requests++;
+    std::string_view request(message);
+    if (request.substr(0, 5) == "?INIT") {
+        respond(sensorsList());
+    } else if (request.substr(0, 9) == "?PROTOCOL") {
+        respond("?type=text");
+    } else if (request.substr(0, 7) == "?UPDATE") {
+        handleUpdate(request.substr(7));
+    }
+    // ?CONFIG and ?STATS are not answered
+}
+
+void SimulatedBus::sendFrame(std::string_view frame) {
+    (void)frame;
+    Requests++;
+}
+
+bool SimulatedBus::pollFrame(std::string_view &frame) {
+    if (Queue.empty() || (long)(getMillis() - Queue.front().ReadyAt) < 0) {
+        return false;
+    }
+
+    Frame = std::move(Queue.front().Data);
+    Queue.pop_front();
+    frame = Frame;
+    return true;
+}
+
+LoopbackBus::LoopbackBus(size_t sensors) {
+    SimulatedBusConfig config;
+    config.Sensors = sensors;
+    SimulatedBus bus(config);
+    List = bus.sensorsList();
+
+    // Value sets are taken from two updates of simulated bus
+    std::string_view frame;
+    size_t capacity = 0;
+    for (size_t set = 0; set < 2; set++) {
+        bus.sendMessage("?UPDATE");
+        bus.pollFrame(frame);
+        // Large sequence number, so delta requests (since=..) do not fit into short string buffer
+        Updates[set] = "?seq=" + std::to_string(4000000000ul + set) + std::string(frame.substr(frame.find('?', 1)));
+        capacity = std::max(capacity, Updates[set].size());
+
+        KeyValueTokenizer records(std::string_view(Updates[set]).substr(1), '?', '\0');
+        KeyValuePair pair;
+        records.next(pair); // seq=..
+        while (records.next(pair)) {
+            Records[set].emplace_back(pair.Key);
+        }
+    }
+    for (std::string &response : Responses) {
+        response.reserve(capacity + 32);
+    }
+}
+
+std::string* LoopbackBus::nextResponse() {
+    const size_t slots = sizeof(Responses) / sizeof(Responses[0]);
+    if (Count == slots) {
+        Head = (Head + 1) % slots; // Oldest response is dropped
+        Count--;
+    }
+    return &Responses[(Head + Count++) % slots];
+}
+
+void LoopbackBus::sendMessage(const std::string &message) {
+    std::string_view request(message);
+    if (request.substr(0, 5) == "?INIT") {
+        nextResponse()->assign(List);
+    } else if (request.substr(0, 7) == "?UPDATE") {
+        // ?UPDATE&id=N&rid=R of asynchronous resync is answered by one record, everything else by full update
+        size_t rid = request.find("&rid=");
+        unsigned long index = 0;
+        if (rid != std::string_view::npos && request.substr(0, 11) == "?UPDATE&id=" &&
+            parseNumber(request.substr(11, rid - 11), index) && index < Records[Toggle].size()) {
+            nextResponse()->assign("?").append(Records[Toggle][index]).append(request.substr(rid));
+        } else {
+            nextResponse()->assign(Updates[Toggle]);
+        }
+        Toggle ^= 1;
+    }
+}
+
+void LoopbackBus::sendFrame(std::string_view frame) {
+    (void)frame;
+}
+
+bool LoopbackBus::pollFrame(std::string_view &frame) {
+    if (Count == 0) {
+        return false;
+    }
+    frame = Responses[Head];
+    Head = (Head + 1) % (sizeof(Responses) / sizeof(Responses[0]));
+    Count--;
+    return true;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file simulated_bus.hpp
+ * @brief Declaration of simulated sensor bus, deterministic in-memory loopback messenger for host benchmarks.
+ *
+ * The bus answers text protocol requests (?INIT, ?PROTOCOL, ?UPDATE, ?CONFIG) of N simulated sensors
+ * (ADC, ADC, TH, ... as fixed sensors list), responses are delivered after configurable latency and jitter,
+ * and some of them can be corrupted. Pseudo-random choices are seeded, so every run is the same.
+ * Values can be replayed from recorded readings log instead (see loadReplay()).
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef SIMULATED_BUS_HPP
+#define SIMULATED_BUS_HPP
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../libraries/messenger.hpp"
+#include "../libraries/recorder.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * @struct SimulatedBusConfig
+ * @brief Configuration of simulated bus.
+ */
+struct SimulatedBusConfig
+{
+    size_t Sensors = 3;               ///< Number of simulated sensors.
+    unsigned long Latency = 0;        ///< Response latency in milliseconds.
+    unsigned long Jitter = 0;         ///< Maximal random latency added to every response in milliseconds.
+    unsigned int CorruptPercent = 0;  ///< Percentage of corrupted responses (0-100).
+    size_t DeadSensors = 0;           ///< Number of last sensors which never answer (offline).
+    uint32_t Seed = 1;                ///< Seed of pseudo-random generator.
+};
+
+/**
+ * @class SimulatedBus
+ * @brief Messenger answering requests of simulated sensors without any hardware.
+ *
+ * Binary frames are accepted and dropped (binary protocol is not negotiated by the bus).
+ */
+class SimulatedBus : public Messenger
+{
+private:
+    /**
+     * @brief Response waiting for delivery.
+     */
+    struct Response
+    {
+        unsigned long ReadyAt; ///< Time of delivery in milliseconds.
+        std::string Data;      ///< Response message.
+    };
+
+    SimulatedBusConfig Config;  ///< Bus configuration.
+    std::deque<Response> Queue; ///< Responses in flight, in order of sending.
+    std::string Frame;          ///< Last delivered response.
+    uint32_t Random;            ///< State of pseudo-random generator.
+    unsigned long Sequence = 0; ///< Update sequence of the simulated device.
+    unsigned long Requests = 0; ///< Number of received requests.
+    std::vector<std::vector<ReadingRecord>> Replay; ///< Recorded readings of every sensor (replay mode).
+    std::vector<size_t> ReplayCursor;               ///< Next replayed reading of every sensor.
+
+    uint32_t nextRandom();
+    void respond(std::string &&data);
+    bool appendReplay(std::string &out, size_t index);
+    void appendSensor(std::string &out, size_t index);
+    void handleUpdate(std::string_view request);
+public:
+    explicit SimulatedBus(const SimulatedBusConfig &config) : Config(config), Random(config.Seed != 0 ? config.Seed : 1) {}
+
+    /**
+     * @brief Get fixed sensors list as answered to ?INIT (e.g. "?0:ADC&1:ADC&2:TH").
+     */
+    std::string sensorsList() const;
+
+    /**
+     * @brief Replay recorded readings instead of synthetic values (sensor handle is index of simulated sensor).
+     *
+     * Every update of sensor delivers its next recorded update (readings with the same timestamp, until slot repeats),
+     * replay of sensor starts again at its end. Sensors without readings keep synthetic values.
+     *
+     * @param readings The recorded readings (see ReadingLogReader).
+     * @return Number of replayed readings, readings of unknown sensors or slots are ignored.
+     */
+    size_t loadReplay(const std::vector<ReadingRecord> &readings);
+
+    /**
+     * @brief Get number of requests received by the bus.
+     */
+    unsigned long requests() const
+    {
+        return Requests;
+    }
+
+    /**
+     * @brief Drop undelivered responses.
+     */
+    void flush()
+    {
+        Queue.clear();
+    }
+
+    void init() override {}
+    void sendMessage(const std::string &message) override;
+    void sendFrame(std::string_view frame) override;
+    bool pollFrame(std::string_view &frame) override;
+};
+
+/**
+ * @class LoopbackBus
+ * @brief Messenger answering requests by prebuilt responses, without any heap allocation after construction.
+ *
+ * Used to check that steady-state synchronization of the manager does not allocate. Sensors are the same as
+ * of SimulatedBus, every update request toggles between two prebuilt value sets (so values change).
+ * Up to MESSENGER_MAX_INFLIGHT + 1 responses wait for delivery, older ones are dropped.
+ */
+class LoopbackBus : public Messenger
+{
+private:
+    std::string List;                    ///< Response of ?INIT.
+    std::string Updates[2];              ///< Full multi-update responses (two value sets).
+    std::vector<std::string> Records[2]; ///< Records of single sensors (two value sets).
+    std::string Responses[MESSENGER_MAX_INFLIGHT + 1]; ///< Ring of pending responses, preallocated.
+    size_t Head = 0;                     ///< Next delivered response.
+    size_t Count = 0;                    ///< Number of pending responses.
+    size_t Toggle = 0;                   ///< Value set of next response.
+
+    std::string* nextResponse();
+public:
+    explicit LoopbackBus(size_t sensors);
+
+    void init() override {}
+    void sendMessage(const std::string &message) override;
+    void sendFrame(std::string_view frame) override;
+    bool pollFrame(std::string_view &frame) override;
+};
+
+#endif // SIMULATED_BUS_HPP
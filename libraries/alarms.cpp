@@ -0,0 +1,44 @@
+/*
+* Copyright 2025 MTA
+* Author: Ing. Jiri Konecny
+*/
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "alarms.hpp"
+#include "helpers.hpp" ///< For parseNumber
+
+ErrorCode compileAlarmRule(std::string_view text, AlarmRule &rule, std::string_view &key) {
+    rule = AlarmRule();
+
+    size_t op = text.find_first_of("<>");
+    if (op == std::string_view::npos || op == 0) {
+        return ErrorCode::INVALID_VALUE;
+    }
+    key = text.substr(0, op);
+    bool rate = key.size() > 2 && key.substr(key.size() - 2) == "/s";
+    if (rate) {
+        key.remove_suffix(2);
+    }
+    if (text[op] == '>') {
+        rule.Op = rate ? AlarmOp::RATE_ABOVE : AlarmOp::ABOVE;
+    } else {
+        rule.Op = rate ? AlarmOp::RATE_BELOW : AlarmOp::BELOW;
+    }
+
+    std::string_view constants = text.substr(op + 1);
+    if (!constants.empty() && constants.back() == '!') {
+        rule.SetStatus = true;
+        constants.remove_suffix(1);
+    }
+    size_t hysteresis = constants.find('~');
+    if (!parseNumber(constants.substr(0, hysteresis), rule.Threshold)) {
+        return ErrorCode::INVALID_VALUE;
+    }
+    if (hysteresis != std::string_view::npos &&
+        (!parseNumber(constants.substr(hysteresis + 1), rule.Hysteresis) || rule.Hysteresis < 0)) {
+        return ErrorCode::INVALID_VALUE;
+    }
+    return ErrorCode::SUCCESS;
+}
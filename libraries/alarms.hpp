@@ -0,0 +1,209 @@
+/**
+ * @file alarms.hpp
+ * @brief Declaration of alarm rules of sensor values (thresholds with hysteresis and rate of change).
+ *
+ * Rules are compiled from text once into flat table of (slot, op, constant) and evaluated incrementally
+ * by sensor update, only for assigned slots watched by some rule. Threshold rules are evaluated only
+ * when value changed, rate rules on every assignment (unchanged value is rate 0 and clears rate alarm).
+ *
+ * Rule text: key[/s](>|<)threshold[~hysteresis][!], several rules are joined by '&', e.g.
+ * "temperature>30~0.5!&humidity<20&temperature/s>2".
+ * - key/s: rate of change of value per second instead of value.
+ * - ~hysteresis: active alarm is cleared only when value returns behind threshold by hysteresis.
+ * - !: sensor status is ERROR while alarm is active (otherwise only callback is called).
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef ALARMS_HPP
+#define ALARMS_HPP
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "config.hpp"      ///< Configuration.
+#include "error_codes.hpp" ///< Error codes.
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+class BaseSensor;
+
+/**
+ * @enum AlarmOp
+ * @brief Compiled alarm condition.
+ */
+enum class AlarmOp : uint8_t {
+    ABOVE,       ///< Value is above threshold.
+    BELOW,       ///< Value is below threshold.
+    RATE_ABOVE,  ///< Rate of change per second is above threshold.
+    RATE_BELOW   ///< Rate of change per second is below threshold.
+};
+
+/**
+ * @struct AlarmRule
+ * @brief Compiled alarm rule with its evaluation state.
+ */
+struct AlarmRule
+{
+    uint8_t Slot = 0;              ///< Value slot (index of value in sensor schema).
+    AlarmOp Op = AlarmOp::ABOVE;   ///< Condition.
+    bool SetStatus = false;        ///< Set sensor status ERROR while active.
+    bool Active = false;           ///< Alarm is active.
+    double Threshold = 0;          ///< Threshold of value or rate.
+    double Hysteresis = 0;         ///< Hysteresis of clearing active alarm.
+    double Previous = 0;           ///< Last evaluated value.
+    unsigned long PreviousTime = 0; ///< Time of last evaluated value in milliseconds.
+    bool HasPrevious = false;      ///< Some value was evaluated.
+};
+
+/**
+ * @brief Callback of alarm change, rule.Active tells if alarm was raised or cleared.
+ */
+typedef void (*AlarmCallback)(BaseSensor &sensor, const AlarmRule &rule, double value, void *context);
+
+/**
+ * @class AlarmTable
+ * @brief Flat table of compiled alarm rules of one sensor.
+ */
+class AlarmTable
+{
+private:
+    std::vector<AlarmRule> Rules; ///< Compiled rules.
+    uint32_t Slots = 0;           ///< Bit mask of slots watched by some rule (slot % 32).
+    uint8_t StatusActive = 0;     ///< Number of active rules setting sensor status.
+
+    /**
+     * @brief Evaluate condition of the rule with hysteresis.
+     */
+    static bool evaluate(const AlarmRule &rule, double value)
+    {
+        bool above = (rule.Op == AlarmOp::ABOVE || rule.Op == AlarmOp::RATE_ABOVE);
+        double threshold = rule.Threshold;
+        if(rule.Active)
+        {
+            threshold += above ? -rule.Hysteresis : rule.Hysteresis; // Clear only behind hysteresis
+        }
+        return above ? value > threshold : value < threshold;
+    }
+public:
+    /**
+     * @brief Add compiled rule.
+     *
+     * @param rule The rule.
+     */
+    void add(const AlarmRule &rule)
+    {
+        Rules.push_back(rule);
+        Slots |= (uint32_t)1 << (rule.Slot % 32);
+    }
+
+    /**
+     * @brief Remove all rules.
+     */
+    void clear()
+    {
+        Rules.clear();
+        Slots = 0;
+        StatusActive = 0;
+    }
+
+    /**
+     * @brief Check if some rule watches the slot (O(1) check before evaluation).
+     */
+    bool watches(size_t slot) const
+    {
+        return (Slots & ((uint32_t)1 << (slot % 32))) != 0;
+    }
+
+    /**
+     * @brief Check if some active rule sets sensor status.
+     */
+    bool isStatusActive() const
+    {
+        return StatusActive > 0;
+    }
+
+    /**
+     * @brief Get compiled rules.
+     */
+    const std::vector<AlarmRule>& rules() const
+    {
+        return Rules;
+    }
+
+    /**
+     * @brief Evaluate rules of assigned value, onChange(rule, value) is called for raised or cleared alarms.
+     *
+     * Threshold rules skip unchanged values, rate rules are evaluated for every assignment with new time.
+     *
+     * @param slot The value slot.
+     * @param value The assigned value.
+     * @param time The time of the value in milliseconds.
+     * @param onChange The callback of alarm change.
+     */
+    template <typename Callback>
+    void update(size_t slot, double value, unsigned long time, Callback &&onChange)
+    {
+        for (AlarmRule &rule : Rules)
+        {
+            if(rule.Slot != slot)
+            {
+                continue;
+            }
+
+            bool active = rule.Active;
+            if(rule.Op == AlarmOp::ABOVE || rule.Op == AlarmOp::BELOW)
+            {
+                if(rule.HasPrevious && rule.Previous == value)
+                {
+                    continue; // Threshold is evaluated only for changed values
+                }
+                active = evaluate(rule, value);
+            }
+            else if(rule.HasPrevious)
+            {
+                if(time == rule.PreviousTime)
+                {
+                    continue; // Rate is evaluated over ellapsed time
+                }
+                double rate = (value - rule.Previous) * 1000.0 / (double)(time - rule.PreviousTime);
+                active = evaluate(rule, rate);
+            }
+            rule.Previous = value;
+            rule.PreviousTime = time;
+            rule.HasPrevious = true;
+
+            if(active != rule.Active)
+            {
+                rule.Active = active;
+                if(rule.SetStatus)
+                {
+                    StatusActive = active ? StatusActive + 1 : StatusActive - 1;
+                }
+                onChange(rule, value);
+            }
+        }
+    }
+};
+
+/*********************
+ *      DECLARES
+ *********************/
+
+/**
+ * @brief Compile one alarm rule (key[/s](>|<)threshold[~hysteresis][!]), slot is not resolved.
+ *
+ * @param text The rule text.
+ * @param rule The output rule.
+ * @param key The output key of the value.
+ * @return SUCCESS or INVALID_VALUE if rule text is not valid.
+ */
+ErrorCode compileAlarmRule(std::string_view text, AlarmRule &rule, std::string_view &key);
+
+#endif // ALARMS_HPP
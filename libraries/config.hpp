@@ -19,9 +19,77 @@
 #define UART1_RX -1
 #define UART1_TX -1
 #define UART_TIMEOUT 100
+/// Adapt update timeouts of links and sensors to measured round trip (smoothed RTT + 4 * deviation), UART_TIMEOUT is upper bound
+#define ADAPTIVE_TIMEOUT
+/// Lower bound of adaptive timeout in milliseconds
+#define TIMEOUT_MIN 10
+/// Consecutive failed updates of sensor before it is marked OFFLINE and skipped (circuit breaker)
+#define SENSOR_MAX_FAILURES 3
+/// First interval of background probes of OFFLINE sensor in milliseconds (doubled after every failed probe)
+#define SENSOR_PROBE_INTERVAL 1000
+/// Maximal backoff exponent of probes of OFFLINE sensor (interval * 2^backoff)
+#define SENSOR_PROBE_MAX_BACKOFF 6
+/// Size of UART receive ring buffer and maximal frame length (power of two)
+#define UART_RX_BUFFER_SIZE 512
+/// Request only parameters changed since last update sequence (devices without support send full state)
+#define UPDATE_DELTA
+/// Uncomment to negotiate compact binary protocol (text protocol is used as fallback)
+// #define PROTOCOL_BINARY
+/// Uncomment to persist sensors topology (list and last configs, NVS or file) and restore it by init(true) before ?INIT is answered
+// #define TOPOLOGY_CACHE
+/// Maximal number of requests in flight for asynchronous resync
+#define MESSENGER_MAX_INFLIGHT 4
+/// Size of sensor pool owned by manager in bytes (sensors over capacity are allocated on heap)
+#define SENSOR_POOL_SIZE 16384
+/// Size of inline sensor error message and source (longer texts are truncated)
+#define SENSOR_ERROR_MESSAGE_SIZE 96
+#define SENSOR_ERROR_SOURCE_SIZE 32
+/// Maximal number of channels of multi-channel sensors (e.g. MADC boards)
+#define SENSOR_MAX_CHANNELS 32
+/// Maximal number of configuration parameters of sensor type (pending configs are tracked by bit mask)
+#define SENSOR_MAX_CONFIGS 32
+/// Number of samples kept by value history (enabled per value by BaseSensor::enableHistory)
+#define SENSOR_HISTORY_SIZE 64
+/// Smoothing factor of exponential moving average in value history
+#define SENSOR_HISTORY_EMA_ALPHA 0.2f
+/// Default freshness of synchronized sensor values in milliseconds, sync() serves cached values while fresh (0 disables cache)
+#define SENSOR_FRESH_TTL 100
+/// Default poll interval of scheduled sensors in milliseconds
+#define SCHEDULER_DEFAULT_INTERVAL 1000
+/// Maximal number of sensors coalesced into one scheduled update request
+#define SCHEDULER_MAX_BATCH 8
+/// Maximal backoff exponent of OFFLINE/ERROR sensors (interval * 2^backoff)
+#define SCHEDULER_MAX_BACKOFF 5
+/// Maximal backoff exponent of sensors without change since last poll
+#define SCHEDULER_IDLE_BACKOFF 2
+/// Size of preallocated buffer of batched multi-sensor CONFIG message (larger batches are split)
+#define CONFIG_BATCH_SIZE 512
+/// Maximal number of numerical values in published sensor snapshot (for readers on other cores/threads)
+#define SENSOR_SNAPSHOT_VALUES 8
+/// Time budget of one redraw() pass in milliseconds, remaining sensors are drawn by next pass
+#define REDRAW_FRAME_BUDGET 8
+/// Intern numerical sensor UIDs (e.g. "0", "12") as integer IDs, looked up by direct index and compared as integers
+#define SENSOR_INTERNED_IDS
+/// Size of interned IDs table (numerical UIDs from 0 to SENSOR_MAX_ID - 1, larger ones use hashed UID index)
+#define SENSOR_MAX_ID 256
+/// Comment out to compile out hot-path instrumentation (timers, counters and latency histograms)
+#define METRICS
+/// Number of power of two buckets of latency histograms in microseconds
+#define METRICS_HISTOGRAM_BUCKETS 24
+/// Uncomment to record every committed value into binary log (memory-mapped file on PC, flash partition ring on Arduino)
+// #define RECORDER
+/// Number of readings buffered by recorder before they are written into the log
+#define RECORDER_BUFFER_SIZE 64
 
 
 /// Uncomment to enable logging for standard console applications (PC/Linux)
 #define STDIO_H 
 
+/// Log level (LOG_LEVEL_NONE, LOG_LEVEL_ERROR, LOG_LEVEL_WARNING, LOG_LEVEL_INFO, LOG_LEVEL_DEBUG), can be set by build target
+#ifndef LOG_LEVEL
+    #define LOG_LEVEL 3
+#endif
+/// Size of log buffer flushed in batches by flushLogs(), 0 to write every log immediately
+#define LOG_BUFFER_SIZE 1024
+
 #endif // CONFIG_H 
\ No newline at end of file
@@ -26,6 +26,7 @@
  * - CRTICAL_ERROR_CODE: Critical error, stop code.
  * - NOT_FOUND: Value not found.
  * - NOT_DEFINED_ERROR: Unknown error.
+ * - SUCCESS: No error, result of non-throwing operations.
  */
 enum class ErrorCode {
     VALUE_ERROR     = -1,  ///< Invalid value error.
@@ -35,7 +36,8 @@ enum class ErrorCode {
     ERROR_CODE,   ///< Operation error.
     CRTICAL_ERROR_CODE, ///< Critical error, stop code.
     NOT_FOUND,   ///< Value not found.  
-    NOT_DEFINED_ERROR  ///< Unknown error.
+    NOT_DEFINED_ERROR,  ///< Unknown error.
+    SUCCESS            ///< No error.
 };
 
 #endif // ERROR_CODES_HPP
@@ -116,6 +116,13 @@ public:
     }
 };
 
+/// Print caught exception, compiled out below LOG_LEVEL_ERROR
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+    #define LOG_EXCEPTION(ex) (ex).print()
+#else
+    #define LOG_EXCEPTION(ex) ((void)0)
+#endif
+
 class ConfigurationNotFoundException : public Exception
 {
 private:
@@ -5,16 +5,68 @@
 
 #include "helpers.hpp"
 
-std::string getValueFromKeyValueLikeString(std::string str, std::string key, char separator = '&') {
-    std::string value;
-    size_t pos = str.find(key);
-    if(pos != std::string::npos) {
-        pos += key.length() + 1;
-        size_t end = str.find(separator, pos);
-        value = str.substr(pos, end - pos);
+#include <charconv> // For std::from_chars
+#include <cstdlib>  // For std::strtod
+#include <cmath>    // For std::isfinite
+
+#if defined(__SSE2__)
+    #include <emmintrin.h> // For SSE2 intrinsics
+#endif
+
+#ifdef ARDUINO_H
+    #include <Arduino.h> // For millis, micros
+#else
+    #include <chrono>    // For std::chrono::steady_clock
+#endif
+
+unsigned long getMillis() {
+    #ifdef ARDUINO_H
+        return millis();
+    #else
+        using namespace std::chrono;
+        return (unsigned long)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+    #endif
+}
+
+unsigned long getMicros() {
+    #ifdef ARDUINO_H
+        return micros();
+    #else
+        using namespace std::chrono;
+        return (unsigned long)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+    #endif
+}
+
+bool KeyValueTokenizer::next(KeyValuePair &pair) {
+    while (!Source.empty()) {
+        size_t end = Source.find(Separator);
+        std::string_view token = Source.substr(0, end);
+        Source = (end == std::string_view::npos) ? std::string_view() : Source.substr(end + 1);
+
+        if (token.empty()) {
+            continue;
+        }
+
+        size_t assign = token.find(Assign);
+        pair.Key = token.substr(0, assign);
+        pair.KeyHash = hashKey(pair.Key);
+        pair.Value = (assign == std::string_view::npos) ? std::string_view() : token.substr(assign + 1);
+        return true;
     }
 
-    return value;
+    return false;
+}
+
+std::string getValueFromKeyValueLikeString(std::string_view str, std::string_view key, char separator) {
+    KeyValueTokenizer tokenizer(str, separator);
+    KeyValuePair pair;
+    while (tokenizer.next(pair)) {
+        if (pair.Key == key) {
+            return std::string(pair.Value);
+        }
+    }
+
+    return std::string();
 }
 
 std::vector<std::string> splitString(std::string str, char separator) {
@@ -34,6 +86,146 @@ std::vector<std::string> splitString(std::string str, char separator) {
     return result;
 }
 
+/**
+ * @brief Check decimal number format [+-]digits[.digits][(e|E)[+-]digits], at least one mantissa digit.
+ * 
+ * Whitespace, inf/nan and hex floats (accepted by strtod) are rejected.
+ */
+static bool isDecimalNumber(std::string_view str) {
+    size_t i = 0;
+    if (i < str.size() && (str[i] == '+' || str[i] == '-')) {
+        i++;
+    }
+    size_t digits = 0;
+    for (; i < str.size() && str[i] >= '0' && str[i] <= '9'; i++) {
+        digits++;
+    }
+    if (i < str.size() && str[i] == '.') {
+        for (i++; i < str.size() && str[i] >= '0' && str[i] <= '9'; i++) {
+            digits++;
+        }
+    }
+    if (digits == 0) {
+        return false;
+    }
+    if (i < str.size() && (str[i] == 'e' || str[i] == 'E')) {
+        i++;
+        if (i < str.size() && (str[i] == '+' || str[i] == '-')) {
+            i++;
+        }
+        size_t exponent = i;
+        for (; i < str.size() && str[i] >= '0' && str[i] <= '9'; i++) {
+        }
+        if (i == exponent) {
+            return false;
+        }
+    }
+    return i == str.size();
+}
+
+bool parseNumber(std::string_view str, double &value) {
+    if (!isDecimalNumber(str)) {
+        return false;
+    }
+
+    double result;
+    #if defined(__cpp_lib_to_chars)
+        // Locale independent, sign is checked by format above (from_chars does not accept '+')
+        const char *begin = str.data() + (str[0] == '+' ? 1 : 0);
+        std::from_chars_result res = std::from_chars(begin, str.data() + str.size(), result);
+        if (res.ec != std::errc() || res.ptr != str.data() + str.size()) {
+            return false;
+        }
+    #else
+        // strtod needs null terminated input, numbers on wire are short
+        char buffer[32];
+        if (str.size() >= sizeof(buffer)) {
+            return false;
+        }
+        str.copy(buffer, str.size());
+        buffer[str.size()] = '\0';
+
+        char *end = nullptr;
+        result = std::strtod(buffer, &end);
+        if (end != buffer + str.size()) {
+            return false;
+        }
+    #endif
+    if (!std::isfinite(result)) {
+        return false; // Out of range
+    }
+
+    value = result;
+    return true;
+}
+
+bool parseNumber(std::string_view str, float &value) {
+    double result;
+    if (!parseNumber(str, result) || !std::isfinite(static_cast<float>(result))) {
+        return false;
+    }
+
+    value = static_cast<float>(result);
+    return true;
+}
+
+bool parseNumber(std::string_view str, int &value) {
+    if (str.empty()) {
+        return false;
+    }
+
+    const char *begin = str.data();
+    const char *end = str.data() + str.size();
+    if (*begin == '+') {
+        begin++;
+        if (begin != end && *begin == '-') {
+            return false; // Only one sign
+        }
+    }
+
+    int result;
+    std::from_chars_result res = std::from_chars(begin, end, result);
+    if (res.ec != std::errc() || begin == end) {
+        return false;
+    }
+    if (res.ptr != end) {
+        // Accept decimal format, value is truncated
+        double real;
+        if (*res.ptr != '.' || !parseNumber(str, real)) {
+            return false;
+        }
+    }
+
+    value = result;
+    return true;
+}
+
+bool parseNumber(std::string_view str, unsigned long &value) {
+    unsigned long result;
+    std::from_chars_result res = std::from_chars(str.data(), str.data() + str.size(), result);
+    if (str.empty() || res.ec != std::errc() || res.ptr != str.data() + str.size()) {
+        return false;
+    }
+
+    value = result;
+    return true;
+}
+
+void scaleSamples(const int32_t *raw, float *out, size_t count, float gain) {
+    size_t i = 0;
+    #if defined(__SSE2__)
+        const __m128 factor = _mm_set1_ps(gain);
+        for (; i + 4 <= count; i += 4) {
+            __m128i samples = _mm_loadu_si128((const __m128i *)(raw + i));
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(samples), factor));
+        }
+    #endif
+    // Remainder (or whole batch without SIMD, simple loop is auto-vectorized by compiler)
+    for (; i < count; i++) {
+        out[i] = (float)raw[i] * gain;
+    }
+}
+
 template <typename T>
 T convertStringToType(const std::string &str) {
     throw std::invalid_argument("Unsupported type conversion");
@@ -47,15 +239,11 @@ int convertStringToType<int>(const std::string &str) {
         return int(); // Return default-constructed int (0)
     }
 
-    try
-    {
-        return std::stoi(str);
-    }
-    catch(const std::exception& e)
-    {
+    int value;
+    if (!parseNumber(str, value)) {
         throw InvalidDataTypeException("convertStringToType<int>", str + " is non-int format string!");
     }
-     
+    return value;
 }
 
 // Specialization for double
@@ -65,14 +253,11 @@ double convertStringToType<double>(const std::string &str) {
         return double(); // Return default double (0.0)
     }
 
-    try
-    {
-        return std::stod(str);
-    }
-    catch(const std::exception& e)
-    {
+    double value;
+    if (!parseNumber(str, value)) {
         throw InvalidDataTypeException("convertStringToType<double>", str + " is non-double format string!");
     }
+    return value;
 }
 
 // Specialization for float
@@ -82,14 +267,11 @@ float convertStringToType<float>(const std::string &str) {
         return float(); // Return default float (0.0f)
     }
 
-    try
-    {
-        return std::stof(str);
-    }
-    catch(const std::exception& e)
-    {
+    float value;
+    if (!parseNumber(str, value)) {
         throw InvalidDataTypeException("convertStringToType<float>", str + " is non-float format string!");
     }
+    return value;
 }
 
 // Specialization for std::string
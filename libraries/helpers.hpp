@@ -9,8 +9,14 @@
 /*********************
  *      INCLUDES
  *********************/
+#include "config.hpp"
 #include "exceptions.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <type_traits>      ///< For is_same
 
@@ -18,6 +24,529 @@
  *      TYPEDEFS
  **********************/
 
+/**
+ * @brief Fold ASCII letter to lower case (keys are ASCII).
+ */
+constexpr char foldCase(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+}
+
+/**
+ * @brief Compute case-folded hash of key (FNV-1a), keys differing only in case have the same hash.
+ *
+ * @param key The key.
+ * @return The hash.
+ */
+constexpr uint32_t hashKey(std::string_view key)
+{
+    uint32_t hash = 2166136261u;
+    for (char c : key)
+    {
+        hash = (hash ^ (uint8_t)foldCase(c)) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Compare keys case-insensitively (ASCII), without rewriting them.
+ */
+constexpr bool equalsIgnoreCase(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if (foldCase(a[i]) != foldCase(b[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Key/value pair view into tokenized string.
+ * 
+ * Both views point into the tokenized source, so they are valid only while the source lives.
+ */
+struct KeyValuePair
+{
+    std::string_view Key;   ///< Parameter key.
+    std::string_view Value; ///< Parameter value (empty if not present).
+    uint32_t KeyHash = 0;   ///< Case-folded hash of key (see hashKey()), computed by tokenizer.
+};
+
+/**
+ * @class KeyValueTokenizer
+ * @brief Single-pass, zero-copy tokenizer of key/value like strings (e.g. "id=0&value=255").
+ * 
+ * Walks the source once and yields key/value pairs as string views, without any allocation.
+ * Empty tokens are skipped, token without assign character is returned as key with empty value.
+ */
+class KeyValueTokenizer
+{
+private:
+    std::string_view Source; ///< Rest of the source to tokenize.
+    char Separator;          ///< Pairs separator.
+    char Assign;             ///< Key/value assign character.
+public:
+    /**
+     * @brief Constructs a new KeyValueTokenizer object.
+     * 
+     * @param source The string to tokenize.
+     * @param separator The pairs separator.
+     * @param assign The key/value assign character.
+     */
+    KeyValueTokenizer(std::string_view source, char separator = '&', char assign = '=')
+    : Source(source), Separator(separator), Assign(assign) {}
+
+    /**
+     * @brief Get next key/value pair.
+     * 
+     * @param pair The output pair.
+     * @return true if pair was found, false if the end of source was reached.
+     */
+    bool next(KeyValuePair &pair);
+};
+
+
+/**
+ * @class RingBuffer
+ * @brief Fixed-size lock-free ring buffer for single producer and single consumer.
+ * 
+ * Producer (e.g. receive interrupt) calls only push(), consumer calls only pop().
+ * No allocation is done, capacity N must be power of two.
+ * 
+ * @tparam T The item type.
+ * @tparam N The capacity.
+ */
+template <typename T, size_t N>
+class RingBuffer
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "RingBuffer capacity must be power of two");
+private:
+    T Data[N];                    ///< Items storage.
+    std::atomic<size_t> Head{0};  ///< Write counter.
+    std::atomic<size_t> Tail{0};  ///< Read counter.
+public:
+    /**
+     * @brief Push item into buffer.
+     * 
+     * @param item The item to push.
+     * @return true if item was pushed, false if buffer is full.
+     */
+    bool push(const T &item)
+    {
+        size_t head = Head.load(std::memory_order_relaxed);
+        if (head - Tail.load(std::memory_order_acquire) >= N) {
+            return false;
+        }
+        Data[head & (N - 1)] = item;
+        Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop item from buffer.
+     * 
+     * @param item The popped item.
+     * @return true if item was popped, false if buffer is empty.
+     */
+    bool pop(T &item)
+    {
+        size_t tail = Tail.load(std::memory_order_relaxed);
+        if (tail == Head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = Data[tail & (N - 1)];
+        Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Get number of items in buffer.
+     */
+    size_t size() const
+    {
+        return Head.load(std::memory_order_acquire) - Tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Check if buffer is empty.
+     */
+    bool empty() const
+    {
+        return size() == 0;
+    }
+};
+
+/**
+ * @class Seqlock
+ * @brief Single-writer sequence lock, readers get consistent copy of T without locking and without blocking writer.
+ * 
+ * Data is stored as atomic words, so concurrent copy is well defined. Writer never waits,
+ * reader retries while write is in progress.
+ * 
+ * @tparam T The trivially copyable data type.
+ */
+template <typename T>
+class Seqlock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock data must be trivially copyable");
+    static constexpr size_t WordsCount = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+private:
+    std::atomic<uint32_t> Sequence{0};         ///< Even when stable, odd during write.
+    std::atomic<uint32_t> Words[WordsCount] = {}; ///< Data storage.
+public:
+    /**
+     * @brief Publish new data (single writer only).
+     * 
+     * @param data The data.
+     */
+    void store(const T &data)
+    {
+        uint32_t words[WordsCount] = {};
+        std::memcpy(words, &data, sizeof(T));
+
+        uint32_t sequence = Sequence.load(std::memory_order_relaxed);
+        Sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WordsCount; i++) {
+            Words[i].store(words[i], std::memory_order_relaxed);
+        }
+        Sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Read consistent copy of data (any thread).
+     * 
+     * @param data The output data.
+     * @param retries The maximal number of retries, while writer is active.
+     * @return true if consistent copy was read, false if writer was active during all retries.
+     */
+    bool load(T &data, size_t retries = 64) const
+    {
+        uint32_t words[WordsCount];
+        for (size_t attempt = 0; attempt <= retries; attempt++) {
+            uint32_t before = Sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+            for (size_t i = 0; i < WordsCount; i++) {
+                words[i] = Words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (Sequence.load(std::memory_order_relaxed) == before) {
+                std::memcpy(&data, words, sizeof(T));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Get number of published versions.
+     */
+    uint32_t version() const
+    {
+        return Sequence.load(std::memory_order_acquire) / 2;
+    }
+};
+
+/**
+ * @brief Streaming statistics of sample history.
+ */
+struct SampleStats
+{
+    float Min = 0;          ///< Minimum since reset.
+    float Max = 0;          ///< Maximum since reset.
+    float Mean = 0;         ///< Mean of samples in history window.
+    float Ema = 0;          ///< Exponential moving average.
+    unsigned long Count = 0; ///< Number of samples since reset.
+};
+
+/**
+ * @brief Zero-copy view of sample history, oldest sample is at index 0.
+ * 
+ * Arrays are ring storage, sample i is at (Start + i) % Capacity (e.g. for chart in circular mode).
+ */
+struct SampleView
+{
+    const float *Values;         ///< Values storage.
+    const unsigned long *Times;  ///< Timestamps storage (milliseconds).
+    size_t Capacity;             ///< Storage size.
+    size_t Start;                ///< Index of the oldest sample.
+    size_t Count;                ///< Number of samples.
+
+    float value(size_t i) const { return Values[(Start + i) % Capacity]; }
+    unsigned long time(size_t i) const { return Times[(Start + i) % Capacity]; }
+};
+
+/**
+ * @class SampleHistory
+ * @brief Fixed-capacity history of timestamped samples with O(1) streaming statistics.
+ * 
+ * Values and timestamps are stored in separate contiguous arrays (chart can use values directly).
+ * 
+ * @tparam N The capacity.
+ */
+template <size_t N>
+class SampleHistory
+{
+    static_assert(N > 0, "SampleHistory capacity must be positive");
+private:
+    float Values[N] = {};         ///< Values storage.
+    unsigned long Times[N] = {};  ///< Timestamps storage.
+    size_t Next = 0;              ///< Index of next sample.
+    size_t Count = 0;             ///< Number of stored samples.
+    double Sum = 0;               ///< Sum of stored samples, for window mean.
+    float Alpha;                  ///< EMA smoothing factor.
+    SampleStats Stats;            ///< Statistics.
+public:
+    /**
+     * @brief Constructs a new SampleHistory object.
+     * 
+     * @param alpha The EMA smoothing factor (0..1], weight of the newest sample.
+     */
+    SampleHistory(float alpha = 0.2f) : Alpha(alpha) {}
+
+    /**
+     * @brief Add sample, the oldest one is overwritten when history is full.
+     * 
+     * @param time The sample timestamp in milliseconds.
+     * @param value The sample value.
+     */
+    void push(unsigned long time, float value)
+    {
+        if (Count == N) {
+            Sum -= Values[Next];
+        } else {
+            Count++;
+        }
+        Values[Next] = value;
+        Times[Next] = time;
+        Next = (Next + 1) % N;
+        Sum += value;
+
+        if (Stats.Count == 0) {
+            Stats.Min = Stats.Max = Stats.Ema = value;
+        } else {
+            Stats.Min = (value < Stats.Min) ? value : Stats.Min;
+            Stats.Max = (value > Stats.Max) ? value : Stats.Max;
+            Stats.Ema += Alpha * (value - Stats.Ema);
+        }
+        Stats.Count++;
+        Stats.Mean = (float)(Sum / (double)Count);
+    }
+
+    /**
+     * @brief Get statistics.
+     */
+    const SampleStats& stats() const
+    {
+        return Stats;
+    }
+
+    /**
+     * @brief Get zero-copy view of stored samples.
+     */
+    SampleView view() const
+    {
+        return SampleView{Values, Times, N, (Next + N - Count) % N, Count};
+    }
+
+    /**
+     * @brief Get number of stored samples.
+     */
+    size_t size() const
+    {
+        return Count;
+    }
+
+    /**
+     * @brief Remove all samples and reset statistics.
+     */
+    void reset()
+    {
+        Next = 0;
+        Count = 0;
+        Sum = 0;
+        Stats = SampleStats();
+    }
+};
+
+/**
+ * @class MemoryArena
+ * @brief Fixed-capacity bump allocator, objects are released all at once by reset().
+ */
+class MemoryArena
+{
+private:
+    unsigned char *Storage; ///< Arena storage.
+    size_t Capacity;        ///< Storage size.
+    size_t Used = 0;        ///< Used bytes.
+public:
+    /**
+     * @brief Constructs a new MemoryArena object over given storage.
+     * 
+     * @param storage The storage, must outlive the arena.
+     * @param capacity The storage size.
+     */
+    MemoryArena(unsigned char *storage, size_t capacity) : Storage(storage), Capacity(capacity) {}
+
+    /**
+     * @brief Allocate memory block.
+     * 
+     * @param size The block size.
+     * @param align The block alignment (power of two).
+     * @return Pointer to the block or nullptr if arena is full.
+     */
+    void* allocate(size_t size, size_t align)
+    {
+        size_t offset = (((size_t)(Storage + Used) + align - 1) & ~(align - 1)) - (size_t)Storage;
+        if (offset + size > Capacity) {
+            return nullptr;
+        }
+        Used = offset + size;
+        return Storage + offset;
+    }
+
+    /**
+     * @brief Check if pointer belongs to the arena.
+     */
+    bool owns(const void *ptr) const
+    {
+        return (const unsigned char *)ptr >= Storage && (const unsigned char *)ptr < Storage + Capacity;
+    }
+
+    /**
+     * @brief Get used bytes, can be used as mark for rewind().
+     */
+    size_t used() const
+    {
+        return Used;
+    }
+
+    /**
+     * @brief Get arena capacity in bytes.
+     */
+    size_t capacity() const
+    {
+        return Capacity;
+    }
+
+    /**
+     * @brief Release blocks allocated after mark (e.g. after failed construction).
+     */
+    void rewind(size_t mark)
+    {
+        if (mark < Used) {
+            Used = mark;
+        }
+    }
+
+    /**
+     * @brief Get free bytes for block with given alignment.
+     */
+    size_t available(size_t align) const
+    {
+        size_t offset = (((size_t)(Storage + Used) + align - 1) & ~(align - 1)) - (size_t)Storage;
+        return (offset < Capacity) ? Capacity - offset : 0;
+    }
+
+    /**
+     * @brief Release all blocks, objects must be already destroyed.
+     */
+    void reset()
+    {
+        Used = 0;
+    }
+};
+
+/**
+ * @class RttEstimator
+ * @brief Round trip estimator of adaptive timeout (smoothed RTT and mean deviation, like TCP retransmission timeout).
+ * 
+ * Timeout is SRTT + 4 * RTTVAR within TIMEOUT_MIN and UART_TIMEOUT, it is doubled after every timeout
+ * until next measured round trip. Without ADAPTIVE_TIMEOUT timeout is always UART_TIMEOUT.
+ */
+class RttEstimator
+{
+private:
+    float Srtt = 0;        ///< Smoothed round trip in milliseconds.
+    float Rttvar = 0;      ///< Mean deviation of round trip in milliseconds.
+    uint8_t Backoff = 0;   ///< Number of timeouts since last sample.
+    bool HasSample = false; ///< Some round trip was measured.
+public:
+    /**
+     * @brief Record measured round trip.
+     * 
+     * @param rtt The round trip in milliseconds.
+     */
+    void record(unsigned long rtt)
+    {
+        float sample = (float)rtt;
+        if(!HasSample)
+        {
+            Srtt = sample;
+            Rttvar = sample / 2;
+            HasSample = true;
+        }
+        else
+        {
+            Rttvar = 0.75f * Rttvar + 0.25f * ((Srtt > sample) ? Srtt - sample : sample - Srtt);
+            Srtt = 0.875f * Srtt + 0.125f * sample;
+        }
+        Backoff = 0;
+    }
+
+    /**
+     * @brief Record timeout, next timeout is doubled.
+     */
+    void recordTimeout()
+    {
+        if(Backoff < 8)
+        {
+            Backoff++;
+        }
+    }
+
+    /**
+     * @brief Check if some round trip was measured.
+     */
+    bool hasSample() const
+    {
+        return HasSample;
+    }
+
+    /**
+     * @brief Get smoothed round trip in milliseconds.
+     */
+    float srtt() const
+    {
+        return Srtt;
+    }
+
+    /**
+     * @brief Get current timeout in milliseconds.
+     */
+    unsigned long timeout() const
+    {
+        #ifdef ADAPTIVE_TIMEOUT
+            if(!HasSample)
+            {
+                return UART_TIMEOUT;
+            }
+            unsigned long timeout = (unsigned long)(Srtt + 4 * Rttvar + 1) << Backoff;
+            return (timeout < TIMEOUT_MIN) ? TIMEOUT_MIN : (timeout > UART_TIMEOUT) ? UART_TIMEOUT : timeout;
+        #else
+            return UART_TIMEOUT;
+        #endif
+    }
+};
 
 /*********************
  *      DECLARES
@@ -27,12 +556,14 @@
  * @brief Get value from update string.
  * 
  * This function extracts the value of a given key from an update string.
+ * Key must match exactly, for multiple keys use KeyValueTokenizer instead.
  * 
  * @param str The input string.
  * @param key The key to search for.
+ * @param separator The pairs separator.
  * @return The value corresponding to the key, if exist.
  */
-std::string getValueFromKeyValueLikeString(std::string str, std::string key, char separator);
+std::string getValueFromKeyValueLikeString(std::string_view str, std::string_view key, char separator = '&');
 
 
 /**
@@ -46,6 +577,103 @@ std::string getValueFromKeyValueLikeString(std::string str, std::string key, cha
  */
 std::vector<std::string> splitString(std::string str, char separator);
 
+/**
+ * @brief Append unsigned number as decimal text, no allocation if string capacity suffices.
+ * 
+ * @param out The output string.
+ * @param value The number.
+ */
+inline void appendNumber(std::string &out, unsigned long value)
+{
+    char buffer[24];
+    char *begin = buffer + sizeof(buffer);
+    do
+    {
+        *--begin = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    out.append(begin, buffer + sizeof(buffer) - begin);
+}
+
+/**
+ * @brief Intern sensor UID as integer ID.
+ * 
+ * Only canonical numerical UIDs (digits without sign and leading zeros, e.g. "0", "12") below SENSOR_MAX_ID
+ * are interned, so every interned ID maps back to exactly one UID.
+ * 
+ * @param uid The unique sensor identifier.
+ * @return The integer ID or -1 if UID can not be interned.
+ */
+inline int internSensorID(std::string_view uid)
+{
+    if (uid.empty() || uid.size() > 9 || (uid.size() > 1 && uid[0] == '0'))
+    {
+        return -1;
+    }
+    int id = 0;
+    for (char c : uid)
+    {
+        if (c < '0' || c > '9')
+        {
+            return -1;
+        }
+        id = id * 10 + (c - '0');
+    }
+    return (id < SENSOR_MAX_ID) ? id : -1;
+}
+
+/**
+ * @brief Get monotonic time in milliseconds.
+ * 
+ * Uses millis() on Arduino, steady clock otherwise.
+ * 
+ * @return Milliseconds since arbitrary start point.
+ */
+unsigned long getMillis();
+
+/**
+ * @brief Get monotonic time in microseconds.
+ * 
+ * Uses micros() on Arduino, steady clock otherwise.
+ * 
+ * @return Microseconds since arbitrary start point (wraps around).
+ */
+unsigned long getMicros();
+
+/**
+ * @brief Parse numerical value from string view.
+ * 
+ * Non-throwing, allocation-free conversion. Whole input must be a decimal number with optional sign
+ * (no whitespace, inf/nan or hex), out of range values are rejected,
+ * integer parse accepts (and truncates) decimal part.
+ * 
+ * @param str The string value to parse.
+ * @param value The output value, untouched on failure.
+ * @return true if conversion succeeded, false otherwise.
+ */
+bool parseNumber(std::string_view str, int &value);
+
+// Overload for unsigned long (no decimal part accepted)
+bool parseNumber(std::string_view str, unsigned long &value);
+
+// Overload for double
+bool parseNumber(std::string_view str, double &value);
+
+// Overload for float
+bool parseNumber(std::string_view str, float &value);
+
+/**
+ * @brief Scale raw samples, out[i] = raw[i] * gain.
+ * 
+ * Batch kernel for multi-channel sensors, vectorized (SSE2) where available.
+ * 
+ * @param raw The raw samples.
+ * @param out The scaled samples, must not overlap raw.
+ * @param count The number of samples.
+ * @param gain The scale factor.
+ */
+void scaleSamples(const int32_t *raw, float *out, size_t count, float gain);
+
 /**
  * @brief Convert string to type.
  * 
@@ -14,6 +14,7 @@
 //#include <stdarg.h>  // For variadic arguments
 #include <cstdarg>  // For variadic arguments
 #include <cstdio>
+#include <mutex>    // For std::recursive_mutex
 #include <string>
 
 #ifdef ARDUINO_H
@@ -22,15 +23,47 @@
     #include <stdio.h>    ///< Include standard I/O functions
 #endif
 
+#if LOG_BUFFER_SIZE > 0
+    static char logBuffer[LOG_BUFFER_SIZE]; ///< Buffered logs.
+    static size_t logLength = 0;            ///< Used size of log buffer.
+    static std::recursive_mutex logMutex;   ///< Log buffer is shared by link workers.
+
+    static void writeLogs(const char *data, size_t size) {
+        #ifdef ARDUINO_H
+            Serial.write((const uint8_t *)data, size);  // Print via Arduino Serial
+        #elif defined(STDIO_H)
+            fwrite(data, 1, size, stdout);  // Print via standard console
+        #endif
+    }
+#endif
+
 void logMessage(const char *format, ...) {
     va_list args;
     va_start(args, format);
 
-    #ifdef ARDUINO_H
+    #if LOG_BUFFER_SIZE > 0
+        std::lock_guard<std::recursive_mutex> lock(logMutex);
+        va_list copy;
+        va_copy(copy, args);
+        int length = vsnprintf(logBuffer + logLength, sizeof(logBuffer) - logLength, format, copy);
+        va_end(copy);
+
+        if (length >= 0 && logLength + (size_t)length >= sizeof(logBuffer)) {
+            // Message does not fit, write out buffered logs and retry
+            flushLogs();
+            length = vsnprintf(logBuffer, sizeof(logBuffer), format, args);
+            if (length >= 0 && (size_t)length >= sizeof(logBuffer)) {
+                length = (int)sizeof(logBuffer) - 1; // Truncated message
+            }
+        }
+        if (length > 0) {
+            logLength += (size_t)length;
+        }
+    #elif defined(ARDUINO_H)
         // Create a buffer for formatted output
         char buffer[256];
         vsnprintf(buffer, sizeof(buffer), format, args);
-        Serial.println(buffer);  // Print via Arduino Serial
+        Serial.print(buffer);  // Print via Arduino Serial
     #elif defined(STDIO_H)
         vprintf(format, args);  // Print via standard console
     #endif
@@ -38,5 +71,15 @@ void logMessage(const char *format, ...) {
     va_end(args);
 }
 
+void flushLogs() {
+    #if LOG_BUFFER_SIZE > 0
+        std::lock_guard<std::recursive_mutex> lock(logMutex);
+        if (logLength > 0) {
+            writeLogs(logBuffer, logLength);
+            logLength = 0;
+        }
+    #endif
+}
+
 #endif // LOGS_HPP
 
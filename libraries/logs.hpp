@@ -14,17 +14,68 @@
  *      INCLUDES
  *********************/
  #include "config.hpp"  ///< Configuration file inclusion
+
+ /*********************
+ *      DEFINES
+ *********************/
+ #define LOG_LEVEL_NONE 0     ///< No logs.
+ #define LOG_LEVEL_ERROR 1    ///< Errors only.
+ #define LOG_LEVEL_WARNING 2  ///< Errors and warnings.
+ #define LOG_LEVEL_INFO 3     ///< Errors, warnings and information.
+ #define LOG_LEVEL_DEBUG 4    ///< All logs, including diagnostics.
+
+ #ifndef LOG_LEVEL
+     #define LOG_LEVEL LOG_LEVEL_INFO
+ #endif
+
+ #ifndef LOG_BUFFER_SIZE
+     #define LOG_BUFFER_SIZE 0
+ #endif
+
+ /// Levelled logs, messages above LOG_LEVEL are compiled out (arguments are not evaluated)
+ #if LOG_LEVEL >= LOG_LEVEL_ERROR
+     #define LOG_ERROR(...) logMessage(__VA_ARGS__)
+ #else
+     #define LOG_ERROR(...) ((void)0)
+ #endif
+
+ #if LOG_LEVEL >= LOG_LEVEL_WARNING
+     #define LOG_WARNING(...) logMessage(__VA_ARGS__)
+ #else
+     #define LOG_WARNING(...) ((void)0)
+ #endif
+
+ #if LOG_LEVEL >= LOG_LEVEL_INFO
+     #define LOG_INFO(...) logMessage(__VA_ARGS__)
+ #else
+     #define LOG_INFO(...) ((void)0)
+ #endif
+
+ #if LOG_LEVEL >= LOG_LEVEL_DEBUG
+     #define LOG_DEBUG(...) logMessage(__VA_ARGS__)
+ #else
+     #define LOG_DEBUG(...) ((void)0)
+ #endif
  
  /**
   * @brief Logs a formatted message to the appropriate output (Serial for Arduino, stdout for PC).
   * 
   * This function supports variadic arguments similar to `printf()`.
+  * With LOG_BUFFER_SIZE > 0, message is only appended into log buffer, which is written
+  * out when full or by flushLogs().
   * 
   * @param format The format string (like in printf).
   * @param ... Additional arguments for formatting.
   */
  void logMessage(const char *format, ...);
 
+ /**
+  * @brief Writes buffered logs to the output.
+  * 
+  * Call it from idle time of main loop (or idle task), no-op if logs are not buffered.
+  */
+ void flushLogs();
+
  
  #endif // LOGS_H
  
\ No newline at end of file
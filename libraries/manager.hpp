@@ -4,6 +4,12 @@
  * 
  * This header defines the manager class for managing sensors.
  * 
+ * Concurrency model: one communication task owns the manager (init, resync, poll, process, reconfigure)
+ * and is the only writer of sensors. After every applied update the sensor publishes immutable snapshot
+ * (see BaseSensor::publish), other tasks (UI, export) on another core/thread read it lock-free by
+ * readSnapshot() without blocking the communication task. Sensors list must not change (init, erase)
+ * while other tasks hold sensor pointers.
+ * 
  * @copyright 2025 MTA
  * @author 
  * Ing. Jiri Konecny
@@ -18,14 +24,164 @@
 #include "messenger.hpp"
 #include "parser.hpp"
 #include "helpers.hpp"
+#include "metrics.hpp"
+#include "topology.hpp"
 
+#include <cstring>
 #include <vector>
+#include <deque>
 #include <algorithm>
+#include <string_view>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+/**
+ * @brief Update request waiting for response in asynchronous resync.
+ */
+struct PendingRequest
+{
+    unsigned int RequestID; ///< Request ID sent as rid, 0 for free slot.
+    BaseSensor* Sensor;     ///< Requested sensor.
+    unsigned long SentAt;   ///< Time of sending in milliseconds.
+};
+
+/**
+ * @brief Poll schedule of sensor, entry of deadline min-heap.
+ */
+struct PollEntry
+{
+    unsigned long Deadline; ///< Time of next poll in milliseconds.
+    unsigned long Interval; ///< Base poll interval in milliseconds.
+    uint8_t Priority;       ///< Priority, higher is polled first among due sensors.
+    uint8_t Backoff;        ///< Backoff exponent, effective interval is Interval * 2^Backoff.
+    BaseSensor* Sensor;     ///< Scheduled sensor.
+};
+
+/**
+ * @brief Heap order of poll entries, earliest deadline (then highest priority) on top.
+ */
+struct PollEntryLater
+{
+    bool operator()(const PollEntry &a, const PollEntry &b) const
+    {
+        if(a.Deadline != b.Deadline)
+        {
+            return (long)(a.Deadline - b.Deadline) > 0;
+        }
+        return a.Priority < b.Priority;
+    }
+};
+
+/**
+ * @brief Link shard, sensors assigned to one messenger are synchronized by its own worker.
+ */
+struct LinkShard
+{
+    Messenger* Link;              ///< Messenger of the shard.
+    unsigned long UpdateSequence; ///< Last device update sequence of the link, for delta updates.
+    std::string Request = {};     ///< Reused buffer of batched update requests (used by worker of the shard).
+};
+
+/**
+ * @class LinkWorker
+ * @brief Persistent worker of additional link, runs resync job of its shard when signaled.
+ * 
+ * Thread (FreeRTOS task on ESP32) is created once by addLink() and lives until the manager is destroyed,
+ * so resync() does not create and delete tasks every refresh cycle.
+ */
+class LinkWorker
+{
+private:
+    std::function<void(bool)> Job;    ///< Resync job, argument is full flag.
+    std::mutex Lock;                  ///< Guards state below.
+    std::condition_variable Signal;   ///< Signals start, finish and stop.
+    bool Running = false;             ///< Job is requested or running.
+    bool Full = false;                ///< Full flag of requested job.
+    bool Stopping = false;            ///< Worker has to exit.
+    std::thread Thread;               ///< Worker thread, started last.
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(Lock);
+        while (true)
+        {
+            Signal.wait(lock, [this]() { return Running || Stopping; });
+            if(Stopping)
+            {
+                return;
+            }
+            bool full = Full;
+            lock.unlock();
+            try
+            {
+                Job(full);
+            }
+            catch(const Exception& e)
+            {
+                LOG_EXCEPTION(e);
+            }
+            lock.lock();
+            Running = false;
+            Signal.notify_all();
+        }
+    }
+public:
+    /**
+     * @brief Start worker thread.
+     * 
+     * @param job The resync job, exceptions are logged by the worker.
+     */
+    explicit LinkWorker(std::function<void(bool)> job) : Job(std::move(job)), Thread(&LinkWorker::run, this) {}
+
+    LinkWorker(const LinkWorker&) = delete;
+    LinkWorker& operator=(const LinkWorker&) = delete;
+
+    /**
+     * @brief Stop and join worker thread (waits for running job).
+     */
+    ~LinkWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(Lock);
+            Stopping = true;
+        }
+        Signal.notify_all();
+        Thread.join();
+    }
+
+    /**
+     * @brief Signal worker to run the job.
+     * 
+     * @param full Flag passed to the job.
+     */
+    void start(bool full)
+    {
+        {
+            std::lock_guard<std::mutex> lock(Lock);
+            Full = full;
+            Running = true;
+        }
+        Signal.notify_all();
+    }
+
+    /**
+     * @brief Wait until started job is finished.
+     */
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(Lock);
+        Signal.wait(lock, [this]() { return !Running; });
+    }
+};
+
 /*
 
 */
@@ -33,26 +189,712 @@ class SensorManager
 {
 private:
     std::vector<BaseSensor*> Sensors;
+    alignas(std::max_align_t) unsigned char SensorPool[SENSOR_POOL_SIZE]; ///< Storage of sensors arena.
+    MemoryArena Arena{SensorPool, sizeof(SensorPool)}; ///< Sensors arena, released as whole by erase().
+    std::vector<BaseSensor*> SyncQueue;             ///< Sensors waiting for asynchronous update request, capacity is reused.
+    size_t SyncHead = 0;                           ///< First waiting sensor of SyncQueue (previous ones were sent).
+    std::string RequestMessage;                    ///< Reused buffer of asynchronous update requests.
+    PendingRequest Pending[MESSENGER_MAX_INFLIGHT] = {}; ///< Requests in flight.
+    unsigned int NextRequestID = 1;                ///< Next request ID (never 0).
+    std::vector<LinkShard> Shards;                 ///< Links, shard 0 is the default messenger.
+    bool Diagnostics = false;                      ///< Print every updated sensor during resync.
+    std::unordered_map<std::string_view, BaseSensor*> SensorIndex; ///< UID index, keys view BaseSensor::UID of owned sensors.
+    std::vector<BaseSensor*> IDTable;              ///< Sensors by interned integer ID (see SENSOR_INTERNED_IDS).
+    std::vector<PollEntry> Schedule;               ///< Poll schedule, min-heap by deadline (see PollEntryLater).
+    std::string ConfigBatch;                       ///< Preallocated buffer of batched CONFIG message.
+    size_t RedrawCursor = 0;                       ///< First sensor of next redraw pass.
+    std::vector<BaseSensor*> Offline;              ///< Sensors with open circuit, probed in background by process().
+    TopologyStore* Topology = nullptr;             ///< Persisted topology, nullptr if not used.
+    std::string TopologyData;                      ///< Last loaded/stored topology.
+    bool TopologyPending = false;                  ///< Sensors list of restored topology waits for ?INIT response.
+    unsigned long TopologySentAt = 0;              ///< Time of sending ?INIT of background topology check.
+    std::vector<std::unique_ptr<LinkWorker>> Workers; ///< Workers of additional links (Workers[i] for shard i + 1), destroyed first.
+
+    /**
+     * @brief Insert sensor into UID index.
+     * 
+     * Sensors with interned ID are indexed by direct table, others by hashed UID.
+     * First registered sensor wins for duplicated UIDs, same as former linear scan.
+     * 
+     * @param sensor The sensor to index.
+     */
+    void indexSensor(BaseSensor* sensor)
+    {
+        bool interned = false;
+        #ifdef SENSOR_INTERNED_IDS
+            if(sensor->ID >= 0)
+            {
+                if((size_t)sensor->ID >= IDTable.size())
+                {
+                    IDTable.resize(sensor->ID + 1, nullptr);
+                }
+                if(IDTable[sensor->ID] == nullptr)
+                {
+                    IDTable[sensor->ID] = sensor;
+                }
+                interned = true;
+            }
+        #endif
+        if(!interned)
+        {
+            SensorIndex.emplace(std::string_view(sensor->UID), sensor);
+        }
+        Schedule.push_back(PollEntry{getMillis(), SCHEDULER_DEFAULT_INTERVAL, 0, 0, sensor});
+        std::push_heap(Schedule.begin(), Schedule.end(), PollEntryLater());
+    }
+
+    /**
+     * @brief Rebuild UID index from the sensors list.
+     */
+    void reindex()
+    {
+        SensorIndex.clear();
+        IDTable.clear();
+        Schedule.clear();
+        SensorIndex.reserve(Sensors.size());
+        for (BaseSensor* sensor : Sensors)
+        {
+            indexSensor(sensor);
+        }
+    }
+
+    /**
+     * @brief Negotiate binary protocol with the device, text protocol is kept if device does not accept it.
+     */
+    void negotiateProtocol()
+    {
+        setBinaryProtocol(false);
+        #ifdef PROTOCOL_BINARY
+            sendMessage("?PROTOCOL&type=binary");
+            std::string response = receiveMessage();
+            bool accepted = getValueFromKeyValueLikeString(response, "type", '&') == "binary";
+            setBinaryProtocol(accepted);
+            LOG_INFO(accepted ? "Binary protocol negotiated.\n" : "Binary protocol not accepted, using text protocol.\n");
+        #endif
+    }
+
+    /**
+     * @brief Batch update of all sensors via binary protocol.
+     * 
+     * Device answers with one frame per sensor, terminated by frame with PROTOCOL_BROADCAST_ID (or timeout).
+     */
+    void resyncBinary(LinkShard &shard, unsigned long since)
+    {
+        BinaryFrameWriter request(ProtocolCommand::UPDATE, PROTOCOL_BROADCAST_ID);
+        #ifdef UPDATE_DELTA
+            request.addInt(0, (int32_t)since);
+        #else
+            (void)since;
+        #endif
+        shard.Link->sendFrame(request.finish());
+        receiveBinaryBatch(shard);
+    }
+
+    /**
+     * @brief Receive and apply binary batch response, terminated by frame with PROTOCOL_BROADCAST_ID (or timeout).
+     * 
+     * @param shard The link shard, only sensors of the shard are updated.
+     * @param track Flag to commit device sequence, false for responses of sensors subset (see requestBatch()).
+     */
+    void receiveBinaryBatch(LinkShard &shard, bool track = true)
+    {
+        std::string_view response;
+        BinaryFrame frame;
+        unsigned long start = getMillis();
+        bool first = true;
+        while (shard.Link->receiveFrame(response, first ? shard.Link->timeout() : UART_TIMEOUT))
+        {
+            if(first)
+            {
+                shard.Link->recordRoundTrip(getMillis() - start);
+                first = false;
+            }
+            if(!decodeFrame(response, frame))
+            {
+                continue;
+            }
+            if(frame.SensorID == PROTOCOL_BROADCAST_ID)
+            {
+                //End of batch carries device sequence number
+                BinaryParamReader reader(frame.Params);
+                BinaryParam param;
+                if(track && reader.next(param) && param.Type == ProtocolType::INT)
+                {
+                    shard.UpdateSequence = (unsigned long)(uint32_t)param.Number.Int;
+                }
+                break;
+            }
+
+            BaseSensor* sensor = getSensor((int)frame.SensorID);
+            if(sensor != nullptr && &sensor->link() == shard.Link && applySensor(sensor, frame) && Diagnostics && sensor->isRedrawPending())
+            {
+                printSensor(sensor);
+            }
+        }
+    }
+
+    /**
+     * @brief Receive and apply text multi-update response (?seq=..?id=..&..?id=..&..), sequence number is tracked.
+     * 
+     * Response is parsed as it arrives (see UpdateStreamParser), every sensor record is applied
+     * as soon as it is complete, memory does not grow with batch size. Sequence number is committed
+     * only when the whole response arrived, on timeout inside the response the unfinished record is dropped
+     * and the previous sequence is kept, so the next delta update repeats records which were not delivered.
+     * 
+     * Device sequence is global for all sensors, so it is not committed from responses of sensors subset
+     * (track is false), otherwise next delta update would miss changes of sensors outside of the subset.
+     * 
+     * @param shard The link shard, only sensors of the shard are updated.
+     * @param full Flag of full update request (sequence may restart).
+     * @param track Flag to commit device sequence, false for responses of sensors subset (see requestBatch()).
+     */
+    void receiveUpdateStream(LinkShard &shard, bool full, bool track = true)
+    {
+        UpdateStreamParser parser;
+        unsigned long sequence = 0; // Sequence of the response, committed only when whole response arrived
+        auto apply = [this, &shard, &sequence](const SensorRecord &record) {
+            if(record.Sequence != 0)
+            {
+                sequence = record.Sequence;
+            }
+            if(CheckRecord(record))
+            {
+                BaseSensor* sensor = (record.ID >= 0) ? getSensor(record.ID) : getSensor(record.UID);
+                if(sensor != nullptr && &sensor->link() == shard.Link && applySensor(sensor, record) && Diagnostics && sensor->isRedrawPending())
+                {
+                    printSensor(sensor);
+                }
+            }
+        };
+
+        //First part is awaited by adaptive timeout of the link, following parts by UART_TIMEOUT
+        std::string_view chunk;
+        bool end = false;
+        bool first = true;
+        unsigned long start = getMillis();
+        while (!end && shard.Link->receiveChunk(chunk, end, first ? shard.Link->timeout() : UART_TIMEOUT))
+        {
+            if(first)
+            {
+                shard.Link->recordRoundTrip(getMillis() - start);
+                first = false;
+            }
+            parser.push(chunk, apply);
+        }
+        if(first)
+        {
+            shard.Link->recordTimeout();
+        }
+        if(!end)
+        {
+            //Timeout inside the response, unfinished record is dropped and sequence is kept (next delta repeats missed records)
+            if(!first)
+            {
+                LOG_WARNING("Update response timed out before its end!\n");
+            }
+            return;
+        }
+        parser.finish(apply);
+        if(track && (sequence > shard.UpdateSequence || (full && sequence != 0)))
+        {
+            shard.UpdateSequence = sequence;
+        }
+    }
+
+    /**
+     * @brief Send one batched update request for given sensors and apply responses.
+     * 
+     * Text protocol: ?UPDATE&id=0,2,5 (response as for ?UPDATE), binary protocol: broadcast UPDATE frame
+     * with full state flag in slot 0 and requested sensor IDs in following slots.
+     * Device sequence of response does not advance delta updates (response covers the batch only).
+     * 
+     * @param shard The link shard of all sensors in batch.
+     * @param batch The sensors to update.
+     * @param count The number of sensors.
+     */
+    void requestBatch(LinkShard &shard, PollEntry* const* batch, size_t count)
+    {
+        unsigned long start = getMillis();
+        if(isBinaryProtocol())
+        {
+            BinaryFrameWriter request(ProtocolCommand::UPDATE, PROTOCOL_BROADCAST_ID);
+            request.addInt(0, 0);
+            for (size_t i = 0; i < count; i++)
+            {
+                if(batch[i]->Sensor->WireID >= 0)
+                {
+                    request.addInt((uint8_t)(i + 1), batch[i]->Sensor->WireID);
+                }
+            }
+            shard.Link->sendFrame(request.finish());
+            receiveBinaryBatch(shard, false);
+            recordLatency(batch, count, start);
+            return;
+        }
+
+        std::string &request = shard.Request;
+        request.assign("?UPDATE&id=");
+        for (size_t i = 0; i < count; i++)
+        {
+            if(i > 0)
+            {
+                request += ',';
+            }
+            request += batch[i]->Sensor->UID;
+        }
+        shard.Link->sendMessage(request);
+        receiveUpdateStream(shard, false, false);
+        recordLatency(batch, count, start);
+    }
+
+    /**
+     * @brief Record round trip of batched request into metrics of its sensors.
+     */
+    static void recordLatency(PollEntry* const* batch, size_t count, unsigned long start)
+    {
+        #ifdef METRICS
+            unsigned long elapsed = getMillis() - start;
+            for (size_t i = 0; i < count; i++)
+            {
+                batch[i]->Sensor->recordLatency(elapsed);
+            }
+        #else
+            (void)batch; (void)count; (void)start;
+        #endif
+    }
+
+    /**
+     * @brief Batch update of sensors of the link shard.
+     * 
+     * @param shard The link shard.
+     * @param full Flag to request full state of all sensors.
+     */
+    void resyncShard(LinkShard &shard, bool full)
+    {
+        unsigned long since = full ? 0 : shard.UpdateSequence;
+        if(isBinaryProtocol())
+        {
+            resyncBinary(shard, since);
+            return;
+        }
+
+        std::string &request = shard.Request;
+        request.assign("?UPDATE");
+        #ifdef UPDATE_DELTA
+            request.append("&since=");
+            appendNumber(request, since);
+        #else
+            (void)since;
+        #endif
+        shard.Link->sendMessage(request);
+        receiveUpdateStream(shard, full);
+    }
+
+    /**
+     * @brief Find shard of the sensor.
+     * 
+     * @return The shard or nullptr if sensor link is not registered by addLink().
+     */
+    LinkShard* findShard(const BaseSensor* sensor)
+    {
+        for (LinkShard &shard : Shards)
+        {
+            if(shard.Link == &sensor->link())
+            {
+                return &shard;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Compute next poll of polled sensor, backoff grows for OFFLINE/ERROR and unchanged sensors.
+     * 
+     * @param entry The poll entry.
+     * @param changed Flag if sensor changed by the poll.
+     * @param now The current time.
+     */
+    static void reschedule(PollEntry &entry, bool changed, unsigned long now)
+    {
+        if(entry.Sensor->Status != SensorStatus::OK)
+        {
+            entry.Backoff = (entry.Backoff < SCHEDULER_MAX_BACKOFF) ? entry.Backoff + 1 : SCHEDULER_MAX_BACKOFF;
+        }
+        else if(!changed)
+        {
+            entry.Backoff = (entry.Backoff < SCHEDULER_IDLE_BACKOFF) ? entry.Backoff + 1 : entry.Backoff;
+        }
+        else
+        {
+            entry.Backoff = 0;
+        }
+        entry.Deadline = now + (entry.Interval << entry.Backoff);
+    }
+    /**
+     * @brief Send changed configs of sensors of the link shard in one batched message.
+     * 
+     * @param shard The link shard.
+     * @return Number of reconfigured sensors.
+     */
+    size_t reconfigureShard(LinkShard &shard)
+    {
+        size_t count = 0;
+        ConfigBatch.assign("?CONFIG");
+        for (BaseSensor* sensor : Sensors)
+        {
+            if(!sensor->hasPendingConfigs() || &sensor->link() != shard.Link)
+            {
+                continue;
+            }
+            count++;
+            if(isBinaryProtocol() && sensor->WireID >= 0)
+            {
+                reconfigureSensor(sensor);
+                continue;
+            }
+
+            ConfigBatch += '?';
+            if(!sensor->appendPendingConfigs(ConfigBatch, CONFIG_BATCH_SIZE))
+            {
+                //Send full batch and continue with new one
+                ConfigBatch.pop_back();
+                if(ConfigBatch.size() > sizeof("?CONFIG") - 1)
+                {
+                    shard.Link->sendMessage(ConfigBatch);
+                }
+                ConfigBatch.assign("?CONFIG?");
+                if(!sensor->appendPendingConfigs(ConfigBatch, CONFIG_BATCH_SIZE))
+                {
+                    LOG_WARNING("Configs of sensor %s do not fit into batch, sent separately.\n", sensor->UID.c_str());
+                    ConfigBatch.pop_back();
+                    reconfigureSensor(sensor);
+                    continue;
+                }
+            }
+            sensor->clearPendingConfigs();
+        }
+        if(ConfigBatch.size() > sizeof("?CONFIG") - 1)
+        {
+            shard.Link->sendMessage(ConfigBatch);
+        }
+        return count;
+    }
+    /**
+     * @brief Build topology text of current sensors (sensors list line, then configs line per sensor).
+     */
+    std::string buildTopology() const
+    {
+        std::string data;
+        for (size_t i = 0; i < Sensors.size(); i++)
+        {
+            if(i > 0)
+            {
+                data += '&';
+            }
+            data.append(Sensors[i]->UID).append(":").append(Sensors[i]->Type);
+        }
+        for (const BaseSensor* sensor : Sensors)
+        {
+            data += '\n';
+            sensor->appendConfigs(data);
+        }
+        return data;
+    }
+
+    /**
+     * @brief Create sensors from persisted topology and apply their last configs.
+     * 
+     * @return true if some sensor was restored.
+     */
+    bool restoreTopology()
+    {
+        if(Topology == nullptr || !Topology->load(TopologyData))
+        {
+            return false;
+        }
+
+        std::string_view data(TopologyData);
+        size_t end = data.find('\n');
+        createSensorList(Sensors, data.substr(0, end), &Arena);
+        if(Sensors.empty())
+        {
+            return false;
+        }
+        reindex();
+
+        while(end != std::string_view::npos)
+        {
+            size_t start = end + 1;
+            end = data.find('\n', start);
+            SensorRecord record = ParseRecord(data.substr(start, (end == std::string_view::npos) ? std::string_view::npos : end - start));
+            BaseSensor* sensor = (record.ID >= 0) ? getSensor(record.ID) : getSensor(record.UID);
+            if(sensor != nullptr && sensor->tryConfig(record.Data) != ErrorCode::SUCCESS)
+            {
+                LOG_WARNING("Invalid cached configuration of sensor %s!\n", sensor->UID.c_str());
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Store topology of current sensors, if it differs from stored one.
+     */
+    void persistTopology()
+    {
+        if(Topology == nullptr)
+        {
+            return;
+        }
+
+        std::string data = buildTopology();
+        if(data != TopologyData && Topology->save(data))
+        {
+            TopologyData = std::move(data);
+        }
+    }
+
+    /**
+     * @brief Reconcile restored sensors with sensors list received from device.
+     * 
+     * Sensors listed with the same type are kept (with their state), others are removed or created,
+     * new sensors are scheduled for asynchronous update. Poll schedule is reset if list changed.
+     * 
+     * @param list The sensors list (e.g. 0:ADC&1:ADC&2:TH).
+     */
+    void applyTopology(std::string_view list)
+    {
+        std::vector<BaseSensor*> sensors;
+        std::vector<BaseSensor*> created;
+        sensors.reserve(Sensors.size());
+        KeyValueTokenizer tokenizer(list, '&', ':');
+        KeyValuePair pair;
+        while (tokenizer.next(pair))
+        {
+            BaseSensor* sensor = getSensor(pair.Key);
+            if(sensor != nullptr && pair.Value == sensor->Type && std::find(sensors.begin(), sensors.end(), sensor) == sensors.end())
+            {
+                sensors.push_back(sensor);
+                continue;
+            }
+            sensor = createSensorByType(pair.Value, pair.Key, &Arena);
+            if(sensor != nullptr)
+            {
+                sensors.push_back(sensor);
+                created.push_back(sensor);
+            }
+        }
+
+        bool changed = !created.empty() || sensors.size() != Sensors.size() || !std::equal(sensors.begin(), sensors.end(), Sensors.begin());
+        if(!changed)
+        {
+            LOG_INFO("Cached topology matches sensors list.\n");
+            return;
+        }
+
+        LOG_INFO("Sensors list differs from cached topology, %d sensors created.\n", (int)created.size());
+        for (BaseSensor* sensor : Sensors)
+        {
+            if(std::find(sensors.begin(), sensors.end(), sensor) != sensors.end())
+            {
+                continue;
+            }
+            //Removed sensor must not stay in queues
+            unqueue(sensor);
+            Offline.erase(std::remove(Offline.begin(), Offline.end(), sensor), Offline.end());
+            for (PendingRequest &request : Pending)
+            {
+                if(request.Sensor == sensor)
+                {
+                    request = PendingRequest();
+                }
+            }
+            destroySensor(sensor, &Arena);
+        }
+        Sensors.swap(sensors);
+        RedrawCursor = 0;
+        reindex();
+        for (BaseSensor* sensor : created)
+        {
+            requestSync(sensor);
+        }
+        persistTopology();
+    }
+
+    /**
+     * @brief Complete background check of restored topology, if ?INIT response arrived.
+     * 
+     * @param wait Flag to wait for the response (before blocking exchange on the default link).
+     */
+    void completeTopologyCheck(bool wait)
+    {
+        if(!TopologyPending)
+        {
+            return;
+        }
+
+        std::string response;
+        bool received = wait ? !(response = Shards[0].Link->receiveMessage()).empty() : Shards[0].Link->pollMessage(response);
+        if(!received)
+        {
+            if(wait || (getMillis() - TopologySentAt) >= UART_TIMEOUT)
+            {
+                LOG_WARNING("No sensors list received, cached topology is kept.\n");
+                TopologyPending = false;
+            }
+            return;
+        }
+
+        TopologyPending = false;
+        if(response.size() < 1 || response[0] != '?')
+        {
+            LOG_WARNING("Invalid sensor list format, cached topology is kept.\n");
+            return;
+        }
+        applyTopology(std::string_view(response).substr(1));
+    }
+    /**
+     * @brief Write readings recorded by last update pass into the readings log (RECORDER only).
+     */
+    void flushReadings()
+    {
+        #ifdef RECORDER
+            getRecorder().flush();
+        #endif
+    }
+    /**
+     * @brief Add sensor with open circuit to background probes.
+     */
+    void trackOffline(BaseSensor* sensor)
+    {
+        if(sensor->isCircuitOpen() && std::find(Offline.begin(), Offline.end(), sensor) == Offline.end())
+        {
+            Offline.push_back(sensor);
+        }
+    }
+
+    /**
+     * @brief Schedule due probes of OFFLINE sensors, recovered sensors are removed from probes.
+     * 
+     * @param now The current time in milliseconds.
+     */
+    void probeOffline(unsigned long now)
+    {
+        for (size_t i = 0; i < Offline.size();)
+        {
+            BaseSensor* sensor = Offline[i];
+            if(!sensor->isCircuitOpen())
+            {
+                Offline[i] = Offline.back();
+                Offline.pop_back();
+                continue;
+            }
+            if(sensor->isProbeDue(now) && !isRequested(sensor))
+            {
+                sensor->beginProbe(now);
+                SyncQueue.push_back(sensor);
+            }
+            i++;
+        }
+    }
+
+    /**
+     * @brief Remove sensor from queue of asynchronous updates (request in flight is kept).
+     * 
+     * @param sensor The sensor.
+     */
+    void unqueue(const BaseSensor* sensor)
+    {
+        SyncQueue.erase(std::remove(SyncQueue.begin() + SyncHead, SyncQueue.end(), sensor), SyncQueue.end());
+    }
+
+    /**
+     * @brief Merge on-demand sync with asynchronous update of the sensor.
+     * 
+     * Queued request is dropped (on-demand sync replaces it), response of request in flight is awaited
+     * by process() for at most 2 * UART_TIMEOUT (unanswered requests time out after UART_TIMEOUT).
+     * 
+     * @param sensor The sensor.
+     * @return true if request in flight was answered.
+     */
+    bool awaitRequest(BaseSensor* sensor)
+    {
+        unqueue(sensor);
+        if(!isInFlight(sensor))
+        {
+            return false;
+        }
+
+        unsigned long start = getMillis();
+        while (isInFlight(sensor) && (getMillis() - start) < 2 * UART_TIMEOUT)
+        {
+            process();
+        }
+        return !isInFlight(sensor);
+    }
+
+    /**
+     * @brief Wait until resync jobs of all link workers are finished.
+     */
+    void waitWorkers()
+    {
+        for (std::unique_ptr<LinkWorker> &worker : Workers)
+        {
+            worker->wait();
+        }
+    }
 public:
     SensorManager(/* args */)
     {
         Sensors = std::vector<BaseSensor*>();
+        Shards.push_back(LinkShard{&getDefaultMessenger(), 0});
+        ConfigBatch.reserve(CONFIG_BATCH_SIZE);
+        #ifdef TOPOLOGY_CACHE
+            Topology = &getDefaultTopologyStore();
+        #endif
+        #ifdef RECORDER
+            if(!getRecorder().isActive())
+            {
+                getRecorder().setSink(getDefaultReadingLog());
+            }
+        #endif
     };
 
-    ~ SensorManager(){};
+    ~ SensorManager()
+    {
+        erase();
+    };
 
     void init(bool fromRequest = false){
+        Shards[0].Link = &getDefaultMessenger();
         initMessenger();
+        erase();
+        for (LinkShard &shard : Shards)
+        {
+            shard.UpdateSequence = 0;
+        }
 
         if(!fromRequest)
         {
-            logMessage("Initializing manager via fixed sensors list...\n");
-            createSensorList(Sensors);
+            LOG_INFO("Initializing manager via fixed sensors list...\n");
+            createSensorList(Sensors, &Arena);
+            reindex();
+            negotiateProtocol();
+            return;
+        }
+
+        //Restore cached topology immediately, sensors list is checked in background
+        if(restoreTopology())
+        {
+            LOG_INFO("Initializing manager via cached topology...\n");
+            negotiateProtocol();
+            sendMessage("?INIT");
+            TopologyPending = true;
+            TopologySentAt = getMillis();
             return;
         }
 
         //else
-        logMessage("Initializing manager via request...\n");
+        LOG_INFO("Initializing manager via request...\n");
 
         std::string request = "?INIT";
         sendMessage(request);
@@ -60,28 +902,93 @@ public:
         //Check request format
         if(response.size() < 1 || response[0] != '?')
         {
-            logMessage("Invalid sensor list format format!\n");
+            LOG_WARNING("Invalid sensor list format format!\n");
             init(false);
             return;
         }
         //Get rid of the '?' character
         response.erase(0, 1);
 
-        createSensorList(Sensors, response); 
+        createSensorList(Sensors, response, &Arena);
+        reindex();
+        negotiateProtocol();
+        persistTopology();
     }
 
-    BaseSensor* getSensor(std::string uid)
+    /**
+     * @brief Set storage of persisted topology used by init(true) (default with TOPOLOGY_CACHE).
+     * 
+     * @param store The topology store (must outlive the manager), nullptr to disable topology cache.
+     */
+    void setTopologyStore(TopologyStore* store)
     {
-        for (BaseSensor* sensor : Sensors)
-        {
-            if(sensor->UID == uid)
+        Topology = store;
+        TopologyData.clear();
+    }
+
+    /**
+     * @brief Check if restored topology still waits for sensors list from device.
+     */
+    bool isTopologyPending() const
+    {
+        return TopologyPending;
+    }
+
+    /**
+     * @brief Get sensor by UID.
+     * 
+     * Interned (numerical) UIDs are looked up by direct index, others via hashed UID index,
+     * no copy of UID is made.
+     * 
+     * @param uid The unique sensor identifier.
+     * @return Pointer to the sensor or nullptr if not found.
+     */
+    BaseSensor* getSensor(std::string_view uid)
+    {
+        #ifdef SENSOR_INTERNED_IDS
+            int id = internSensorID(uid);
+            if(id >= 0)
             {
-                return sensor;
+                return getSensor(id);
             }
+        #endif
+        auto it = SensorIndex.find(uid);
+        if(it != SensorIndex.end())
+        {
+            return it->second;
         }
         return nullptr;
     }
 
+    /**
+     * @brief Get sensor by numerical ID.
+     * 
+     * @param id The numerical sensor identifier (e.g. 2 for UID "2").
+     * @return Pointer to the sensor or nullptr if not found.
+     */
+    BaseSensor* getSensor(int id)
+    {
+        #ifdef SENSOR_INTERNED_IDS
+            if(id >= 0 && id < SENSOR_MAX_ID)
+            {
+                return ((size_t)id < IDTable.size()) ? IDTable[id] : nullptr;
+            }
+        #endif
+        return getSensor(std::string_view(std::to_string(id)));
+    }
+
+    /**
+     * @brief Read last published snapshot of sensor, safe from any core/thread.
+     * 
+     * @param sensor The sensor obtained by getSensor() after init.
+     * @param snapshot The output snapshot.
+     * @return true if consistent snapshot was read, false otherwise.
+     */
+    static bool readSnapshot(const BaseSensor* sensor, SensorSnapshot &snapshot)
+    {
+        return sensor != nullptr && sensor->readSnapshot(snapshot);
+    }
+
     void addSensor(BaseSensor* sensor)
     {
         if(sensor == nullptr)
@@ -90,18 +997,57 @@ public:
         }
 
         Sensors.push_back(sensor);
+        indexSensor(sensor);
     }
 
-    void sync(std::string id)
+    /**
+     * @brief Synchronize sensor on demand, repeated syncs are coalesced.
+     * 
+     * Fresh values (see BaseSensor::setFreshTTL()) are served from cache, sync of sensor with asynchronous
+     * request already queued or in flight waits for its response, only otherwise the sensor is synchronized.
+     * 
+     * @param id The unique sensor identifier.
+     */
+    void sync(std::string_view id)
     {
+        completeTopologyCheck(true);
+        BaseSensor* sensor = getSensor(id);
+        if(sensor == nullptr)
+        {
+            return;
+        }
+        if(sensor->isFresh(getMillis()))
+        {
+            METRIC_COUNT(SYNC_CACHED, 1);
+            return;
+        }
+        if(awaitRequest(sensor) && sensor->isFresh(getMillis()))
+        {
+            METRIC_COUNT(SYNC_COALESCED, 1);
+            return;
+        }
+        syncSensor(sensor);
+        trackOffline(sensor);
+    }
+
+    /**
+     * @brief Synchronize sensor with real sensor, regardless of cached values.
+     * 
+     * @param id The unique sensor identifier.
+     */
+    void refresh(std::string_view id)
+    {
+        completeTopologyCheck(true);
         BaseSensor* sensor = getSensor(id);
         if(sensor != nullptr)
         {
+            awaitRequest(sensor); // Response of earlier request must not be taken as response of this one
             syncSensor(sensor);
+            trackOffline(sensor);
         }
     }
 
-    void print(std::string uid)
+    void print(std::string_view uid)
     {
         BaseSensor* sensor = getSensor(uid);
         printSensor(sensor);
@@ -113,60 +1059,597 @@ public:
         {
             printSensor(sensor);
         }
+        flushLogs();
     }
 
-    void redraw()
+    /**
+     * @brief Incremental redraw of visible sensors within frame budget.
+     * 
+     * UI of visible sensors is constructed lazily, only sensors with pending redraw are drawn.
+     * Pass stops when budget is spent and next pass continues with the following sensor,
+     * so one refresh does not stall input.
+     * 
+     * @param budget The time budget in milliseconds (0 for unlimited).
+     * @return true if all visible sensors are drawn, false if some are left for next pass.
+     */
+    bool redraw(unsigned long budget = REDRAW_FRAME_BUDGET)
     {
-        for (BaseSensor* sensor : Sensors)
+        unsigned long start = getMillis();
+        size_t count = Sensors.size();
+        for (size_t i = 0; i < count; i++)
         {
-            drawSensor(sensor);
+            BaseSensor* sensor = Sensors[(RedrawCursor + i) % count];
+            if(!sensor->needsDraw())
+            {
+                continue;
+            }
+
+            {
+                METRIC_SCOPE(DRAW);
+                constructSensor(sensor);
+                drawSensor(sensor);
+            }
+            if(budget > 0 && (getMillis() - start) >= budget)
+            {
+                //Remaining work is checked first, pass which drew the last pending sensor is complete
+                for (size_t next = i + 1; next < count; next++)
+                {
+                    if(Sensors[(RedrawCursor + next) % count]->needsDraw())
+                    {
+                        RedrawCursor = (RedrawCursor + next) % count;
+                        return false;
+                    }
+                }
+                return true;
+            }
         }
+        return true;
     }
 
+    /**
+     * @brief Set visibility of the sensor on screen (e.g. scrolled out of list).
+     * 
+     * @param uid The unique sensor identifier.
+     * @param visible Flag if sensor is visible.
+     */
+    void setVisible(std::string_view uid, bool visible)
+    {
+        BaseSensor* sensor = getSensor(uid);
+        if(sensor != nullptr)
+        {
+            sensor->setVisible(visible);
+        }
+    }
+
+    /**
+     * @brief Mark UI of all sensors for reconstruction, visible sensors are constructed by next redraw().
+     */
     void reconstruct()
     {
         for (BaseSensor* sensor : Sensors)
         {
-            constructSensor(sensor);
+            sensor->resetConstruction();
         }   
     }
 
-    //Batch multi-update
-    void resync()
+    /**
+     * @brief Enable diagnostic dump of updated sensors during resync.
+     * 
+     * @param enable Flag to print every updated sensor (costly, for debugging only).
+     */
+    void setDiagnostics(bool enable)
+    {
+        Diagnostics = enable;
+    }
+
+    /**
+     * @brief Batch multi-update of all sensors.
+     * 
+     * With UPDATE_DELTA, only parameters changed since last received sequence are requested
+     * and only changed sensors are marked for redraw. With more links (see addLink()), every link
+     * is synchronized in parallel by its own persistent worker (see LinkWorker), shard 0 by the calling thread.
+     * While background topology check waits for sensors list, the default link is skipped (without waiting).
+     * 
+     * @param full Flag to request full state of all sensors.
+     */
+    void resync(bool full = false)
+    {
+        METRIC_SCOPE(RESYNC);
+        completeTopologyCheck(false);
+        bool deferred = TopologyPending; // Sensors list comes first on the default link
+        if(Shards.size() == 1)
+        {
+            if(!deferred)
+            {
+                resyncShard(Shards[0], full);
+            }
+            flushReadings();
+            flushLogs();
+            return;
+        }
+
+        //Every link is synchronized in parallel by its own worker, sensors of links are disjoint
+        for (std::unique_ptr<LinkWorker> &worker : Workers)
+        {
+            worker->start(full);
+        }
+        try
+        {
+            if(!deferred)
+            {
+                resyncShard(Shards[0], full);
+            }
+        }
+        catch(...)
+        {
+            waitWorkers();
+            throw;
+        }
+        waitWorkers();
+        flushReadings();
+        flushLogs();
+    }
+
+    /**
+     * @brief Send configs changed by setConfig() of all sensors in one batched message.
+     * 
+     * Text protocol: ?CONFIG?id=0&key=value?id=2&key=value (split if it exceeds CONFIG_BATCH_SIZE),
+     * binary protocol: one CONFIG frame per sensor with changed slots only. One batch is sent per link.
+     * 
+     * @return Number of reconfigured sensors.
+     */
+    size_t reconfigure()
+    {
+        completeTopologyCheck(true);
+        size_t count = 0;
+        for (LinkShard &shard : Shards)
+        {
+            count += reconfigureShard(shard);
+        }
+        if(count > 0)
+        {
+            persistTopology();
+        }
+        flushLogs();
+        return count;
+    }
+
+    /**
+     * @brief Set poll interval and priority of the sensor for poll().
+     * 
+     * @param uid The unique sensor identifier.
+     * @param interval The poll interval in milliseconds.
+     * @param priority The priority, higher is polled first when more sensors are due.
+     * @return true if sensor was found, false otherwise.
+     */
+    bool setPollInterval(std::string_view uid, unsigned long interval, uint8_t priority = 0)
+    {
+        for (PollEntry &entry : Schedule)
+        {
+            if(entry.Sensor->UID == uid)
+            {
+                entry.Interval = interval;
+                entry.Priority = priority;
+                entry.Backoff = 0;
+                entry.Deadline = getMillis() + interval;
+                std::make_heap(Schedule.begin(), Schedule.end(), PollEntryLater());
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Poll due sensors by schedule, has to be called from main loop.
+     * 
+     * Due sensors (up to SCHEDULER_MAX_BATCH, by deadline and priority) are coalesced into one batched
+     * update request. OFFLINE/ERROR and unchanged sensors back off automatically (see SCHEDULER_*_BACKOFF).
+     * While background topology check waits for sensors list, sensors of the default link stay due (without waiting).
+     * 
+     * @return Number of polled sensors.
+     */
+    size_t poll()
+    {
+        METRIC_SCOPE(POLL);
+        completeTopologyCheck(false);
+        Messenger* deferred = TopologyPending ? Shards[0].Link : nullptr; // Sensors list comes first on the default link
+        unsigned long now = getMillis();
+        PollEntry batch[SCHEDULER_MAX_BATCH];
+        uint32_t changes[SCHEDULER_MAX_BATCH];
+        size_t count = 0;
+        while (count < SCHEDULER_MAX_BATCH && !Schedule.empty() && (long)(now - Schedule.front().Deadline) >= 0)
+        {
+            std::pop_heap(Schedule.begin(), Schedule.end(), PollEntryLater());
+            batch[count] = Schedule.back();
+            Schedule.pop_back();
+            changes[count] = batch[count].Sensor->getChangeCount();
+            count++;
+        }
+        if(count == 0)
+        {
+            return 0;
+        }
+
+        //Coalesce due sensors of every link into one request
+        for (LinkShard &shard : Shards)
+        {
+            if(shard.Link == deferred)
+            {
+                continue;
+            }
+            PollEntry* requested[SCHEDULER_MAX_BATCH];
+            size_t size = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                if(&batch[i].Sensor->link() == shard.Link)
+                {
+                    requested[size++] = &batch[i];
+                }
+            }
+            if(size > 0)
+            {
+                requestBatch(shard, requested, size);
+            }
+        }
+
+        now = getMillis();
+        size_t polled = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            //Sensor changed if update applied some change (independently of drawing), deferred sensors stay due
+            if(&batch[i].Sensor->link() != deferred)
+            {
+                reschedule(batch[i], batch[i].Sensor->getChangeCount() != changes[i], now);
+                polled++;
+            }
+            Schedule.push_back(batch[i]);
+            std::push_heap(Schedule.begin(), Schedule.end(), PollEntryLater());
+        }
+        flushReadings();
+        flushLogs();
+        return polled;
+    }
+
+    /**
+     * @brief Schedule asynchronous update of all sensors.
+     * 
+     * Requests are sent and responses applied by process(), which has to be called from main loop.
+     */
+    void requestResync()
     {
-        /*
         for (BaseSensor* sensor : Sensors)
         {
-            syncSensor(sensor);
+            //OFFLINE sensors are only probed in background
+            if(!sensor->isCircuitOpen())
+            {
+                requestSync(sensor);
+            }
+        }
+    }
+
+    /**
+     * @brief Schedule asynchronous update of the sensor.
+     * 
+     * @param sensor The sensor to update, already scheduled sensor is not added again.
+     */
+    void requestSync(BaseSensor* sensor)
+    {
+        if(sensor == nullptr || isQueued(sensor))
+        {
+            return;
+        }
+
+        SyncQueue.push_back(sensor);
+    }
+
+    /**
+     * @brief Check if asynchronous update of the sensor is queued (not sent yet).
+     * 
+     * @param sensor The sensor.
+     */
+    bool isQueued(const BaseSensor* sensor) const
+    {
+        return std::find(SyncQueue.begin() + SyncHead, SyncQueue.end(), sensor) != SyncQueue.end();
+    }
+
+    /**
+     * @brief Check if asynchronous update of the sensor is queued or in flight.
+     * 
+     * @param sensor The sensor.
+     */
+    bool isRequested(const BaseSensor* sensor) const
+    {
+        return isQueued(sensor) || isInFlight(sensor);
+    }
+
+    /**
+     * @brief Check if asynchronous update of the sensor waits for response.
+     * 
+     * @param sensor The sensor.
+     */
+    bool isInFlight(const BaseSensor* sensor) const
+    {
+        for (const PendingRequest &request : Pending)
+        {
+            if(request.RequestID != 0 && request.Sensor == sensor)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Check if asynchronous resync is still running.
+     * 
+     * @return true if some request is queued or in flight.
+     */
+    bool isSyncPending() const
+    {
+        return SyncHead < SyncQueue.size() || isInFlight();
+    }
+
+    /**
+     * @brief Check if some request waits for response.
+     * 
+     * @return true if some request is in flight.
+     */
+    bool isInFlight() const
+    {
+        for (const PendingRequest &request : Pending)
+        {
+            if(request.RequestID != 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Process asynchronous resync step, without waiting for the link.
+     * 
+     * Applies arrived responses (matched by request ID), drops timed out requests
+     * and keeps up to MESSENGER_MAX_INFLIGHT requests in flight.
+     */
+    void process()
+    {
+        completeTopologyCheck(false);
+        unsigned long now = getMillis();
+
+        //Drop timed out requests (adaptive timeout of sensor), sensor stays not synchronized
+        for (PendingRequest &request : Pending)
+        {
+            if(request.RequestID != 0 && (now - request.SentAt) >= request.Sensor->timeout())
+            {
+                LOG_WARNING("Update request %u for sensor %s timed out!\n", request.RequestID, request.Sensor->UID.c_str());
+                METRIC_COUNT(TIMEOUTS, 1);
+                if(request.Sensor->recordFailure(now))
+                {
+                    trackOffline(request.Sensor);
+                }
+                request = PendingRequest();
+            }
+        }
+        probeOffline(now);
+
+        //Fill free slots with queued sensors, sent part of queue is dropped when it is at least half (capacity is kept)
+        if(SyncHead > 0 && 2 * SyncHead >= SyncQueue.size())
+        {
+            SyncQueue.erase(SyncQueue.begin(), SyncQueue.begin() + SyncHead);
+            SyncHead = 0;
+        }
+        for (PendingRequest &request : Pending)
+        {
+            if(SyncHead == SyncQueue.size())
+            {
+                break;
+            }
+            if(request.RequestID != 0)
+            {
+                continue;
+            }
+
+            request.Sensor = SyncQueue[SyncHead++];
+            request.RequestID = NextRequestID++;
+            if(NextRequestID == 0)
+            {
+                NextRequestID = 1;
+            }
+            request.SentAt = now;
+            if(isBinaryProtocol() && request.Sensor->WireID >= 0)
+            {
+                request.Sensor->link().sendFrame(BinaryFrameWriter(ProtocolCommand::UPDATE, (uint8_t)request.Sensor->WireID).finish());
+            }
+            else
+            {
+                RequestMessage.assign("?UPDATE&id=").append(request.Sensor->UID).append("&rid=");
+                appendNumber(RequestMessage, request.RequestID);
+                request.Sensor->link().sendMessage(RequestMessage);
+            }
         }
-        */
-       std::string request = "?UPDATE";
-       sendMessage(request);
-
-       std::string response = receiveMessage();
-       std::vector<std::string> responses = splitString(response, '?');
-       for(std::string resp : responses)
-       {
-           SensorMetadata metadata = ParseMetadata(resp);
-           if(CheckMetadata(&metadata))
-           {
-               BaseSensor* sensor = getSensor(metadata.UID);
-               if(sensor != nullptr)
-               {
-                   updateSensor(sensor, metadata.Data);
-                   printSensor(sensor);
-               }
-           }
-       }
-    } 
-    
+
+        //Apply responses as they arrive (binary responses are matched by sensor ID)
+        for (LinkShard &shard : Shards)
+        {
+            if(TopologyPending && &shard == &Shards[0])
+            {
+                continue; // Sensors list comes first on the default link
+            }
+            processResponses(shard);
+        }
+        flushReadings();
+        flushLogs();
+    }
+
+    /**
+     * @brief Add link (e.g. another UART or serial port), sensors of every link are synchronized in parallel.
+     * 
+     * @param link The initialized messenger, must outlive the manager.
+     * @return Index of the link shard (0 is the default messenger).
+     */
+    size_t addLink(Messenger &link)
+    {
+        for (size_t i = 0; i < Shards.size(); i++)
+        {
+            if(Shards[i].Link == &link)
+            {
+                return i;
+            }
+        }
+        Shards.push_back(LinkShard{&link, 0});
+        size_t index = Shards.size() - 1;
+        Workers.emplace_back(new LinkWorker([this, index](bool full) {
+            resyncShard(Shards[index], full);
+        }));
+        return index;
+    }
+
+    /**
+     * @brief Assign sensor to the link shard.
+     * 
+     * @param uid The unique sensor identifier.
+     * @param shard The index of the link shard returned by addLink().
+     * @return true if sensor was assigned, false if sensor or shard is not found.
+     */
+    bool assignSensor(std::string_view uid, size_t shard)
+    {
+        BaseSensor* sensor = getSensor(uid);
+        if(sensor == nullptr || shard >= Shards.size())
+        {
+            return false;
+        }
+
+        sensor->setLink(shard == 0 ? nullptr : Shards[shard].Link);
+        return true;
+    }
+
+    /**
+     * @brief Get number of links.
+     */
+    size_t getLinksCount() const
+    {
+        return Shards.size();
+    }
+
+    /**
+     * @brief Get runtime metrics as STATS message (requires METRICS, see config.hpp).
+     * 
+     * Format: ?STATS&uptime=..&sent=..&timeouts=..&resync_n=..&resync_avg=..&resync_p99=..&resync_max=..
+     * followed by ?id=0&updates=..&errors=..&update_us=..&latency=..&latency_max=.. per sensor.
+     * Timer durations are in microseconds, sensor latency (request round trip) in milliseconds.
+     * 
+     * @param sensors Flag to include metrics of every sensor.
+     * @return The STATS message.
+     */
+    std::string getStats(bool sensors = true) const
+    {
+        std::string stats = "?STATS";
+        ::getMetrics().format(stats);
+        if(sensors)
+        {
+            for (const BaseSensor* sensor : Sensors)
+            {
+                stats += '?';
+                sensor->appendStats(stats);
+            }
+        }
+        return stats;
+    }
+
+    /**
+     * @brief Send STATS message (see getStats()) via the default messenger.
+     * 
+     * @param sensors Flag to include metrics of every sensor.
+     */
+    void sendStats(bool sensors = true)
+    {
+        sendMessage(getStats(sensors));
+    }
+
+    /**
+     * @brief Reset global metrics and metrics of all sensors.
+     */
+    void resetStats()
+    {
+        ::getMetrics().reset();
+        for (BaseSensor* sensor : Sensors)
+        {
+            sensor->resetStats();
+        }
+    }
+
+private:
+    /**
+     * @brief Apply arrived asynchronous responses of the link shard.
+     * 
+     * @param shard The link shard.
+     */
+    void processResponses(LinkShard &shard)
+    {
+        std::string_view response;
+        while (isInFlight() && shard.Link->pollFrame(response))
+        {
+            //Frame view is valid until next poll, record views into it
+            BinaryFrame frame;
+            bool binary = decodeFrame(response, frame);
+            SensorRecord metadata;
+            if(!binary)
+            {
+                metadata = ParseRecord(response.substr((!response.empty() && response[0] == '?') ? 1 : 0));
+            }
+
+            for (PendingRequest &request : Pending)
+            {
+                if(request.RequestID == 0)
+                {
+                    continue;
+                }
+                if(&request.Sensor->link() != shard.Link)
+                {
+                    continue;
+                }
+                if(binary ? (request.Sensor->WireID == (int)frame.SensorID) : (request.RequestID == metadata.RequestID))
+                {
+                    //Only applied response is success, invalid values are failure (sensor returning garbage is not healthy)
+                    if(binary ? applySensor(request.Sensor, frame) : applySensor(request.Sensor, metadata))
+                    {
+                        request.Sensor->recordSuccess(getMillis() - request.SentAt);
+                    }
+                    else if(request.Sensor->recordFailure(getMillis()))
+                    {
+                        trackOffline(request.Sensor);
+                    }
+                    #ifdef METRICS
+                        request.Sensor->recordLatency(getMillis() - request.SentAt);
+                    #endif
+                    request = PendingRequest();
+                    break;
+                }
+            }
+        }
+    }
+
+public:
+
     void erase()
     {
+        SyncQueue.clear();
+        SyncHead = 0;
+        std::fill(std::begin(Pending), std::end(Pending), PendingRequest());
         for (BaseSensor* sensor : Sensors)
         {
-            delete sensor;
+            destroySensor(sensor, &Arena);
         }
         Sensors.clear();
+        SensorIndex.clear();
+        IDTable.clear();
+        Schedule.clear();
+        RedrawCursor = 0;
+        Offline.clear();
+        TopologyPending = false;
+        Arena.reset();
+        flushLogs();
     }
 };
 
@@ -14,63 +14,418 @@
  #define MESSANGER_HPP
 
 #include "messenger.hpp"
+#include "helpers.hpp"    ///< For RingBuffer, getMillis
+#include "metrics.hpp"    ///< For METRIC_SCOPE, METRIC_COUNT
 
 #ifdef ARDUINO_H
     #include <Arduino.h>  ///< Include Arduino 
     #include <HardwareSerial.h> ///< Include Arduino Serial functions
+#else
+    #include <thread>     ///< For std::this_thread::yield
+#endif
 
-    HardwareSerial UART1(UART1_PORT);
+bool FrameAssembler::poll(std::string_view &frame) {
+    char c;
+    while (Ring.pop(c)) {
+        // Binary frame, framed by length
+        if (FrameLength == 0 && !FrameOverflow && (uint8_t)c == PROTOCOL_SYNC) {
+            BinaryLength = PROTOCOL_HEADER_SIZE;
+        }
+        if (BinaryLength > 0) {
+            Frame[FrameLength++] = c;
+            if (FrameLength == PROTOCOL_HEADER_SIZE) {
+                BinaryLength = PROTOCOL_HEADER_SIZE + (uint8_t)c + 1;
+            }
+            if (FrameLength == BinaryLength) {
+                frame = std::string_view(Frame, FrameLength);
+                FrameLength = 0;
+                BinaryLength = 0;
+                return true;
+            }
+            continue;
+        }
+
+        // Text frame, framed by new line
+        if (c == '\r') {
+            continue;
+        }
+        if (c != '\n') {
+            if (FrameLength < sizeof(Frame)) {
+                Frame[FrameLength++] = c;
+            } else {
+                FrameOverflow = true;
+            }
+            continue;
+        }
+
+        size_t length = FrameLength;
+        bool overflow = FrameOverflow;
+        FrameLength = 0;
+        FrameOverflow = false;
+        if (length > 0 && !overflow) {
+            frame = std::string_view(Frame, length);
+            return true;
+        }
+    }
+
+    return false;
+}
 
-    void sendMessage(const std::string &message) {
-        UART1.println(message.c_str());
+bool FrameAssembler::pollText(std::string_view &chunk, bool &end) {
+    if (BinaryLength > 0) {
+        return false;
     }
-    
-    std::string receiveMessage() {
-        String msg = ""; // static so it persists between calls
-        unsigned long startTime = millis();
 
-        while (UART1.available() == 0 && (millis() - startTime) < UART_TIMEOUT) {
-          // Wait until data arrives or timeout occurs
+    char c;
+    end = false;
+    while (FrameLength < sizeof(Frame) && Ring.pop(c)) {
+        if (c == '\r') {
+            continue;
+        }
+        if (c == '\n') {
+            end = true;
+            break;
         }
+        Frame[FrameLength++] = c;
+    }
+    if (FrameLength == 0 && !end) {
+        return false;
+    }
+
+    chunk = std::string_view(Frame, FrameLength);
+    FrameLength = 0;
+    FrameOverflow = false;
+    return true;
+}
 
-        if (Serial.available() > 0) {
-          // Read response
-          msg = UART1.readString();
-        } else {
-          // Handle timeout situation
-          // Do nothing
+bool Messenger::receiveFrame(std::string_view &frame, unsigned long timeout) {
+    METRIC_SCOPE(RECEIVE);
+    unsigned long startTime = getMillis();
+
+    // Wait until complete frame arrives or timeout occurs
+    while (!pollFrame(frame)) {
+        if ((getMillis() - startTime) >= timeout) {
+            METRIC_COUNT(TIMEOUTS, 1);
+            return false;
         }
+        #ifdef ARDUINO_H
+            yield();
+        #else
+            std::this_thread::yield();
+        #endif
+    }
+
+    METRIC_COUNT(MESSAGES_RECEIVED, 1);
+    METRIC_COUNT(BYTES_RECEIVED, frame.size());
+    return true;
+}
 
-        return std::string(msg.c_str());
+std::string Messenger::receiveMessage(unsigned long timeout) {
+    std::string_view frame;
+    return receiveFrame(frame, timeout) ? std::string(frame) : std::string();
+}
+
+bool Messenger::pollChunk(std::string_view &chunk, bool &end) {
+    if (!pollFrame(chunk)) {
+        return false;
     }
-    
-    void initMessenger(unsigned long baudrate = UART1_BAUDRATE, unsigned int mode = SERIAL_8N1, int tx = UART1_TX, int rx = UART1_RX) {
-        UART1.begin(baudrate, mode, tx, rx);
-        while(!UART1);
+    end = true;
+    return true;
+}
+
+bool Messenger::receiveChunk(std::string_view &chunk, bool &end, unsigned long timeout) {
+    METRIC_SCOPE(RECEIVE);
+    unsigned long startTime = getMillis();
+
+    // Wait until some part arrives or timeout occurs
+    while (!pollChunk(chunk, end)) {
+        if ((getMillis() - startTime) >= timeout) {
+            METRIC_COUNT(TIMEOUTS, 1);
+            return false;
+        }
+        #ifdef ARDUINO_H
+            yield();
+        #else
+            std::this_thread::yield();
+        #endif
     }
 
-    void initMessenger() {
-        initMessenger(UART1_BAUDRATE, SERIAL_8N1, UART1_TX, UART1_RX);
+    METRIC_COUNT(MESSAGES_RECEIVED, end ? 1 : 0);
+    METRIC_COUNT(BYTES_RECEIVED, chunk.size());
+    return true;
+}
+
+bool Messenger::pollMessage(std::string &message) {
+    std::string_view frame;
+    if (!pollFrame(frame)) {
+        return false;
+    }
+
+    METRIC_COUNT(MESSAGES_RECEIVED, 1);
+    METRIC_COUNT(BYTES_RECEIVED, frame.size());
+    message.assign(frame.data(), frame.size());
+    return true;
+}
+
+#ifdef ARDUINO_H
+    HardwareSerial UART1(UART1_PORT);
+    UartMessenger defaultMessenger(UART1, UART1_BAUDRATE, SERIAL_8N1, UART1_TX, UART1_RX);
+
+    /**
+     * @brief UART receive event handler, moves received bytes into ring buffer.
+     */
+    void UartMessenger::onReceive() {
+        while (Uart.available() > 0) {
+            if (!Assembler.push((char)Uart.read())) {
+                break; // Ring is full, keep rest in UART FIFO
+            }
+        }
+    }
+
+    void UartMessenger::configure(unsigned long baudrate, unsigned int mode, int tx, int rx) {
+        Baudrate = baudrate;
+        Mode = mode;
+        Tx = tx;
+        Rx = rx;
+    }
+
+    void UartMessenger::init() {
+        Uart.begin(Baudrate, Mode, Tx, Rx);
+        while(!Uart);
+        Uart.onReceive([this]() { onReceive(); });
+    }
+
+    void UartMessenger::sendMessage(const std::string &message) {
+        METRIC_SCOPE(SEND);
+        METRIC_COUNT(MESSAGES_SENT, 1);
+        METRIC_COUNT(BYTES_SENT, message.size() + 2);
+        Uart.println(message.c_str());
+    }
+
+    void UartMessenger::sendFrame(std::string_view frame) {
+        METRIC_SCOPE(SEND);
+        METRIC_COUNT(MESSAGES_SENT, 1);
+        METRIC_COUNT(BYTES_SENT, frame.size());
+        Uart.write((const uint8_t *)frame.data(), frame.size());
+    }
+
+    bool UartMessenger::pollFrame(std::string_view &frame) {
+        return Assembler.poll(frame);
+    }
+
+    bool UartMessenger::pollChunk(std::string_view &chunk, bool &end) {
+        return Assembler.pollText(chunk, end);
+    }
+
+    void initMessenger(unsigned long baudrate = UART1_BAUDRATE, unsigned int mode = SERIAL_8N1, int tx = UART1_TX, int rx = UART1_RX) {
+        defaultMessenger.configure(baudrate, mode, tx, rx);
+        defaultMessenger.init();
     }
 
 #elif defined(STDIO_H)
     #include <stdio.h>    ///< Include standard I/O functions
 
-    void sendMessage(const std::string &message) {
+    ConsoleMessenger defaultMessenger;
+
+    void ConsoleMessenger::init() {
+        // No initialization needed for standard I/O
+        return;
+    }
+
+    void ConsoleMessenger::sendMessage(const std::string &message) {
+        METRIC_SCOPE(SEND);
+        METRIC_COUNT(MESSAGES_SENT, 1);
+        METRIC_COUNT(BYTES_SENT, message.size() + 1);
+        flushLogs(); // Keep order of logs and messages on shared console
         printf("%s\n", message.c_str());
     }
 
-    std::string receiveMessage() {
-        char buffer[256];
-        scanf("%s", buffer);
-        return std::string(buffer);
+    void ConsoleMessenger::sendFrame(std::string_view frame) {
+        METRIC_SCOPE(SEND);
+        METRIC_COUNT(MESSAGES_SENT, 1);
+        METRIC_COUNT(BYTES_SENT, frame.size());
+        flushLogs(); // Keep order of logs and messages on shared console
+        for (char c : frame) {
+            printf("%02X", (unsigned int)(uint8_t)c);
+        }
+        printf("\n");
     }
 
-    void initMessenger() {
-        // No initialization needed for standard I/O
-        return;
+    bool ConsoleMessenger::pollFrame(std::string_view &frame) {
+        flushLogs(); // Console is shared with logs, show them before waiting for input
+        char format[16];
+        snprintf(format, sizeof(format), "%%%ds", (int)sizeof(Frame) - 1);
+        if (scanf(format, Frame) != 1) {
+            return false;
+        }
+
+        frame = std::string_view(Frame);
+        return !frame.empty();
     }
-    
+
+    bool ConsoleMessenger::receiveFrame(std::string_view &frame, unsigned long timeout) {
+        // Console read blocks, no timeout
+        (void)timeout;
+        METRIC_SCOPE(RECEIVE);
+        if (!pollFrame(frame)) {
+            return false;
+        }
+        METRIC_COUNT(MESSAGES_RECEIVED, 1);
+        METRIC_COUNT(BYTES_RECEIVED, frame.size());
+        return true;
+    }
+
+    #ifdef __unix__
+        #include <fcntl.h>    ///< For open
+        #include <termios.h>  ///< For serial port settings
+        #include <unistd.h>   ///< For read, write, close
+        #include <poll.h>     ///< For poll
+        #include <cerrno>     ///< For errno
+
+        static speed_t toSpeed(unsigned long baudrate) {
+            switch (baudrate) {
+            case 1200: return B1200;
+            case 2400: return B2400;
+            case 4800: return B4800;
+            case 9600: return B9600;
+            case 19200: return B19200;
+            case 38400: return B38400;
+            case 57600: return B57600;
+            case 115200: return B115200;
+            case 230400: return B230400;
+            default: return B9600;
+            }
+        }
+
+        SerialPortMessenger::~SerialPortMessenger() {
+            if (Handle >= 0) {
+                close(Handle);
+            }
+        }
+
+        void SerialPortMessenger::init() {
+            if (Handle >= 0) {
+                close(Handle);
+            }
+            Handle = open(Path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+            if (Handle < 0) {
+                throw Exception("SerialPortMessenger::init", "Can not open serial port: " + Path);
+            }
+
+            termios settings = {};
+            if (tcgetattr(Handle, &settings) != 0) {
+                throw Exception("SerialPortMessenger::init", "Can not read serial port settings: " + Path);
+            }
+            cfmakeraw(&settings);
+            cfsetispeed(&settings, toSpeed(Baudrate));
+            cfsetospeed(&settings, toSpeed(Baudrate));
+            settings.c_cflag |= CLOCAL | CREAD;
+            if (tcsetattr(Handle, TCSANOW, &settings) != 0) {
+                throw Exception("SerialPortMessenger::init", "Can not set serial port settings: " + Path);
+            }
+        }
+
+        void SerialPortMessenger::sendMessage(const std::string &message) {
+            METRIC_SCOPE(SEND);
+            METRIC_COUNT(MESSAGES_SENT, 1);
+            METRIC_COUNT(BYTES_SENT, message.size() + 1);
+            write(message);
+            write("\n");
+        }
+
+        void SerialPortMessenger::sendFrame(std::string_view frame) {
+            METRIC_SCOPE(SEND);
+            METRIC_COUNT(MESSAGES_SENT, 1);
+            METRIC_COUNT(BYTES_SENT, frame.size());
+            write(frame);
+        }
+
+        void SerialPortMessenger::write(std::string_view frame) {
+            while (Handle >= 0 && !frame.empty()) {
+                ssize_t written = ::write(Handle, frame.data(), frame.size());
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                        throw Exception("SerialPortMessenger::write", "Write to serial port failed: " + Path);
+                    }
+                    // Port is non-blocking (for receive), wait until output buffer drains
+                    struct pollfd output = { Handle, POLLOUT, 0 };
+                    int ready = ::poll(&output, 1, UART_TIMEOUT);
+                    if (ready == 0) {
+                        throw Exception("SerialPortMessenger::write", "Write to serial port timed out: " + Path);
+                    }
+                    if ((ready < 0 && errno != EINTR) || (ready > 0 && (output.revents & (POLLERR | POLLHUP | POLLNVAL)))) {
+                        throw Exception("SerialPortMessenger::write", "Write to serial port failed: " + Path);
+                    }
+                    continue;
+                }
+                frame.remove_prefix((size_t)written);
+            }
+        }
+
+        void SerialPortMessenger::receive() {
+            char buffer[64];
+            ssize_t count;
+            size_t space;
+            // Read at most free space of the ring, rest is kept in kernel buffer
+            while (Handle >= 0 && (space = Assembler.space()) > 0
+                && (count = read(Handle, buffer, (space < sizeof(buffer)) ? space : sizeof(buffer))) > 0) {
+                for (ssize_t i = 0; i < count; i++) {
+                    Assembler.push(buffer[i]);
+                }
+            }
+        }
+
+        bool SerialPortMessenger::pollFrame(std::string_view &frame) {
+            if (Assembler.poll(frame)) {
+                return true;
+            }
+            receive();
+            return Assembler.poll(frame);
+        }
+
+        bool SerialPortMessenger::pollChunk(std::string_view &chunk, bool &end) {
+            receive();
+            return Assembler.pollText(chunk, end);
+        }
+    #endif
+
 #endif
 
+static Messenger *activeMessenger = &defaultMessenger; ///< Default messenger in use.
+
+Messenger& getDefaultMessenger() {
+    return *activeMessenger;
+}
+
+void setDefaultMessenger(Messenger *messenger) {
+    activeMessenger = (messenger != nullptr) ? messenger : &defaultMessenger;
+}
+
+void sendMessage(const std::string &message) {
+    activeMessenger->sendMessage(message);
+}
+
+void sendFrame(std::string_view frame) {
+    activeMessenger->sendFrame(frame);
+}
+
+std::string receiveMessage() {
+    return activeMessenger->receiveMessage();
+}
+
+bool pollFrame(std::string_view &frame) {
+    return activeMessenger->pollFrame(frame);
+}
+
+bool pollMessage(std::string &message) {
+    return activeMessenger->pollMessage(message);
+}
+
+void initMessenger() {
+    activeMessenger->init();
+}
+
 #endif // MESSANGER_HPP
\ No newline at end of file
@@ -2,8 +2,8 @@
  * @file messenger.hpp
  * @brief Declaration of the messenger interface and related global functions.
  * 
- * This header declares the global functions for message operations. It includes configuration
- * and exception handling support.
+ * This header declares the messenger (transport) objects and the global functions for message
+ * operations over the default messenger. It includes configuration and exception handling support.
  * 
  * @copyright 2024 MTA
  * @author 
@@ -12,12 +12,295 @@
 
  #ifndef MESSENGER_HPP
  #define MESSENGER_HPP
- 
+
  #include "config.hpp"     ///< Configuration.
  #include "exceptions.hpp" ///< Exception handling.
+ #include "protocol.hpp"   ///< Binary frames.
+ #include "helpers.hpp"    ///< For RingBuffer
  #include <string>
+ #include <string_view>
  
 
+ static_assert(UART_RX_BUFFER_SIZE >= PROTOCOL_MAX_FRAME, "UART_RX_BUFFER_SIZE must fit binary frame");
+
+ /**
+  * @class FrameAssembler
+  * @brief Assembles received bytes into frames, without allocation.
+  * 
+  * Text frame ends with new line, binary frame (starting with PROTOCOL_SYNC) is framed by its length byte.
+  * Bytes are pushed by receive event (producer) and frames are assembled by poll (consumer).
+  */
+ class FrameAssembler
+ {
+ private:
+     RingBuffer<char, UART_RX_BUFFER_SIZE> Ring; ///< Received bytes.
+     char Frame[UART_RX_BUFFER_SIZE];            ///< Frame being assembled / last complete frame.
+     size_t FrameLength = 0;                     ///< Length of assembled frame.
+     bool FrameOverflow = false;                 ///< Frame did not fit into buffer, drop until frame end.
+     size_t BinaryLength = 0;                    ///< Expected length of binary frame, 0 for text frame.
+ public:
+     /**
+      * @brief Push received byte (receive event side).
+      * 
+      * @return false if ring is full.
+      */
+     bool push(char c)
+     {
+         return Ring.push(c);
+     }
+
+     /**
+      * @brief Get number of bytes, which can be pushed before ring is full.
+      */
+     size_t space() const
+     {
+         return UART_RX_BUFFER_SIZE - Ring.size();
+     }
+
+     /**
+      * @brief Assemble next complete frame from received bytes.
+      * 
+      * @param frame The view of received frame, valid until next poll (valid only if true is returned).
+      * @return true if complete frame was assembled, false otherwise.
+      */
+     bool poll(std::string_view &frame);
+
+     /**
+      * @brief Take received part of text frame, for streaming of frames longer than the buffer.
+      * 
+      * @param chunk The view of received part, valid until next poll (valid only if true is returned).
+      * @param end Set to true if the part ends the frame (new line).
+      * @return true if some part was received, false otherwise (or if binary frame is being assembled).
+      */
+     bool pollText(std::string_view &chunk, bool &end);
+ };
+
+ /**
+  * @class Messenger
+  * @brief Transport link to the real sensors (e.g. one UART or serial port).
+  * 
+  * Each link can be used by its own task, operations of one link are not thread-safe.
+  */
+ class Messenger
+ {
+ protected:
+     RttEstimator RoundTrip; ///< Measured round trip of update requests over the link.
+ public:
+     virtual ~Messenger() {}
+
+     /**
+      * @brief Initializes the link.
+      * 
+      * @throws Exception if initialization fails.
+      */
+     virtual void init() = 0;
+
+     /**
+      * @brief Sends a text message, new line is appended.
+      * 
+      * @param message The message to send.
+      * @throws Exception if sending fails.
+      */
+     virtual void sendMessage(const std::string &message) = 0;
+
+     /**
+      * @brief Sends a binary frame.
+      * 
+      * @param frame The encoded frame (see protocol.hpp).
+      * @throws Exception if sending fails.
+      */
+     virtual void sendFrame(std::string_view frame) = 0;
+
+     /**
+      * @brief Polls for a complete frame, without blocking and allocation.
+      * 
+      * @param frame The view of received frame, valid until next receive call (valid only if true is returned).
+      * @return true if complete frame was received, false otherwise.
+      */
+     virtual bool pollFrame(std::string_view &frame) = 0;
+
+     /**
+      * @brief Receives a complete frame, waits up to timeout, without allocation.
+      * 
+      * @param frame The view of received frame, valid until next receive call (valid only if true is returned).
+      * @param timeout The timeout in milliseconds.
+      * @return true if frame was received, false on timeout.
+      */
+     virtual bool receiveFrame(std::string_view &frame, unsigned long timeout = UART_TIMEOUT);
+
+     /**
+      * @brief Receives a message, waits up to timeout.
+      * 
+      * @param timeout The timeout in milliseconds.
+      * @return A string containing the received message, empty on timeout.
+      */
+     std::string receiveMessage(unsigned long timeout);
+
+     /**
+      * @brief Receives a message, waits up to UART_TIMEOUT.
+      * 
+      * @return A string containing the received message, empty on timeout.
+      */
+     std::string receiveMessage()
+     {
+         return receiveMessage(UART_TIMEOUT);
+     }
+
+     /**
+      * @brief Polls for received part of text message, without blocking.
+      * 
+      * Large responses can be processed as they arrive, with constant memory.
+      * Default implementation passes whole message (see pollFrame()) as one part.
+      * 
+      * @param chunk The view of received part, valid until next receive call (valid only if true is returned).
+      * @param end Set to true if the part ends the message.
+      * @return true if some part was received, false otherwise.
+      */
+     virtual bool pollChunk(std::string_view &chunk, bool &end);
+
+     /**
+      * @brief Receives part of text message, waits up to timeout for next part.
+      * 
+      * @param chunk The view of received part, valid until next receive call (valid only if true is returned).
+      * @param end Set to true if the part ends the message.
+      * @param timeout The timeout in milliseconds.
+      * @return true if some part was received, false on timeout.
+      */
+     bool receiveChunk(std::string_view &chunk, bool &end, unsigned long timeout = UART_TIMEOUT);
+
+     /**
+      * @brief Record measured round trip of update request over the link.
+      * 
+      * @param rtt The round trip in milliseconds.
+      */
+     void recordRoundTrip(unsigned long rtt)
+     {
+         RoundTrip.record(rtt);
+     }
+
+     /**
+      * @brief Record timed out update request over the link.
+      */
+     void recordTimeout()
+     {
+         RoundTrip.recordTimeout();
+     }
+
+     /**
+      * @brief Get adaptive timeout of update request over the link (see RttEstimator).
+      */
+     unsigned long timeout() const
+     {
+         return RoundTrip.timeout();
+     }
+
+     /**
+      * @brief Polls for a complete message, without blocking.
+      * 
+      * @param message The received message (valid only if true is returned).
+      * @return true if complete message was received, false otherwise.
+      */
+     bool pollMessage(std::string &message);
+ };
+
+ #ifdef ARDUINO_H
+     class HardwareSerial;
+
+     /**
+      * @class UartMessenger
+      * @brief Messenger over Arduino HardwareSerial, received bytes are collected from UART receive event.
+      */
+     class UartMessenger : public Messenger
+     {
+     private:
+         HardwareSerial &Uart;     ///< UART port.
+         unsigned long Baudrate;   ///< Baudrate.
+         unsigned int Mode;        ///< Serial mode (e.g. SERIAL_8N1).
+         int Tx;                   ///< Transmit pin.
+         int Rx;                   ///< Receive pin.
+         FrameAssembler Assembler; ///< Received frames.
+
+         void onReceive();
+     public:
+         UartMessenger(HardwareSerial &uart, unsigned long baudrate, unsigned int mode, int tx, int rx)
+         : Uart(uart), Baudrate(baudrate), Mode(mode), Tx(tx), Rx(rx) {}
+
+         /**
+          * @brief Change port settings, applied by next init().
+          */
+         void configure(unsigned long baudrate, unsigned int mode, int tx, int rx);
+
+         void init() override;
+         void sendMessage(const std::string &message) override;
+         void sendFrame(std::string_view frame) override;
+         bool pollFrame(std::string_view &frame) override;
+         bool pollChunk(std::string_view &chunk, bool &end) override;
+     };
+ #elif defined(STDIO_H)
+     /**
+      * @class ConsoleMessenger
+      * @brief Messenger over standard console, frames are white-space separated words.
+      * 
+      * Console input has no non-blocking read, so poll reads one message as receiveMessage().
+      * Binary frames are sent as hex dump.
+      */
+     class ConsoleMessenger : public Messenger
+     {
+     private:
+         char Frame[UART_RX_BUFFER_SIZE]; ///< Last received frame.
+     public:
+         void init() override;
+         void sendMessage(const std::string &message) override;
+         void sendFrame(std::string_view frame) override;
+         bool pollFrame(std::string_view &frame) override;
+         bool receiveFrame(std::string_view &frame, unsigned long timeout = UART_TIMEOUT) override;
+     };
+
+     #ifdef __unix__
+         /**
+          * @class SerialPortMessenger
+          * @brief Messenger over serial port device (e.g. /dev/ttyUSB0), raw mode and non-blocking reads.
+          */
+         class SerialPortMessenger : public Messenger
+         {
+         private:
+             std::string Path;         ///< Device path.
+             unsigned long Baudrate;   ///< Baudrate.
+             int Handle = -1;          ///< File descriptor.
+             FrameAssembler Assembler; ///< Received frames.
+
+             void receive();
+             /// Write whole frame, waits (poll) while output buffer of non-blocking port is full.
+             void write(std::string_view frame);
+         public:
+             SerialPortMessenger(const std::string &path, unsigned long baudrate) : Path(path), Baudrate(baudrate) {}
+             ~SerialPortMessenger();
+
+             void init() override;
+             void sendMessage(const std::string &message) override;
+             void sendFrame(std::string_view frame) override;
+             bool pollFrame(std::string_view &frame) override;
+             bool pollChunk(std::string_view &chunk, bool &end) override;
+         };
+     #endif
+ #endif
+
+ /**
+  * @brief Get the default (global) messenger, UART1 on Arduino or console.
+  * 
+  * @return The default messenger.
+  */
+ Messenger& getDefaultMessenger();
+
+ /**
+  * @brief Replace the default (global) messenger, e.g. by simulated bus on host.
+  * 
+  * Has to be called before SensorManager::init(), sensors without own link use the default messenger.
+  * 
+  * @param messenger The messenger (must outlive its use), nullptr to restore UART1 or console.
+  */
+ void setDefaultMessenger(Messenger *messenger);
+
  /**
   * @brief Sends a message using the global messenger.
   * 
@@ -25,7 +308,17 @@
   * @throws Exception if sending fails.
   */
  void sendMessage(const std::string &message);
- 
+
+ /**
+  * @brief Sends a binary frame using the global messenger.
+  * 
+  * Console (STDIO) prints the frame as hex dump.
+  * 
+  * @param frame The encoded frame (see protocol.hpp).
+  * @throws Exception if sending fails.
+  */
+ void sendFrame(std::string_view frame);
+
  /**
   * @brief Receives a message using the global messenger.
   * 
@@ -33,7 +326,31 @@
   * @throws Exception if receiving fails.
   */
  std::string receiveMessage();
- 
+
+ /**
+  * @brief Polls the global messenger for a complete frame, without blocking and allocation.
+  * 
+  * On Arduino, bytes are collected into ring buffer from UART receive event. Text frame ends with new line,
+  * binary frame (starting with PROTOCOL_SYNC) is framed by its length byte.
+  * Console input (STDIO) has no non-blocking read, so it reads one message as receiveMessage().
+  * 
+  * @param frame The view of received frame, valid until next receive call (valid only if true is returned).
+  * @return true if complete frame was received, false otherwise.
+  */
+ bool pollFrame(std::string_view &frame);
+
+ /**
+  * @brief Polls the global messenger for a complete message, without blocking.
+  * 
+  * On Arduino only already received bytes are consumed, message ends with new line.
+  * Console input (STDIO) has no non-blocking read, so it reads one message as receiveMessage().
+  * 
+  * @param message The received message (valid only if true is returned).
+  * @return true if complete message was received, false otherwise.
+  * @throws Exception if receiving fails.
+  */
+ bool pollMessage(std::string &message);
+
 /**
 * @brief Initializes the global messenger.
 * 
@@ -51,6 +368,5 @@
   * @throws Exception if initialization fails.
   */
  void initMessenger();
- 
+
  #endif // MESSENGER_HPP
- 
\ No newline at end of file
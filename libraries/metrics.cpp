@@ -0,0 +1,113 @@
+/*
+* Copyright 2025 MTA
+* Author: Ing. Jiri Konecny
+*/
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "metrics.hpp"
+
+/**********************
+ *     VARIABLES
+ **********************/
+static const char* const timerNames[(size_t)MetricTimer::COUNT] = {
+    "send", "receive", "parse", "update", "print", "draw", "resync", "poll"
+};
+
+static const char* const counterNames[(size_t)MetricCounter::COUNT] = {
+    "sent", "received", "bytes_sent", "bytes_received", "timeouts", "invalid", "sync_cached", "sync_coalesced"
+};
+
+void LatencyHistogram::record(uint32_t micros) {
+    size_t bucket = 0;
+    while (bucket + 1 < METRICS_HISTOGRAM_BUCKETS && (micros >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+    Buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    Count.fetch_add(1, std::memory_order_relaxed);
+    Total.fetch_add(micros, std::memory_order_relaxed);
+
+    uint32_t max = Max.load(std::memory_order_relaxed);
+    while (micros > max && !Max.compare_exchange_weak(max, micros, std::memory_order_relaxed)) {
+    }
+}
+
+uint32_t LatencyHistogram::mean() const {
+    uint32_t count = Count.load(std::memory_order_relaxed);
+    return count == 0 ? 0 : (uint32_t)(Total.load(std::memory_order_relaxed) / count);
+}
+
+uint32_t LatencyHistogram::percentile(unsigned int percent) const {
+    uint32_t count = Count.load(std::memory_order_relaxed);
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = ((uint64_t)count * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+        seen += Buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // Upper bound of bucket, but never above the longest sample
+            uint32_t bound = (i + 1 < 32) ? ((uint32_t)1 << (i + 1)) - 1 : UINT32_MAX;
+            uint32_t max = Max.load(std::memory_order_relaxed);
+            return bound < max ? bound : max;
+        }
+    }
+    return Max.load(std::memory_order_relaxed);
+}
+
+void LatencyHistogram::reset() {
+    for (std::atomic<uint32_t> &bucket : Buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    Count.store(0, std::memory_order_relaxed);
+    Total.store(0, std::memory_order_relaxed);
+    Max.store(0, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::format(std::string &out) const {
+    out += "&uptime=";
+    out += std::to_string(uptime());
+    for (size_t i = 0; i < (size_t)MetricCounter::COUNT; i++) {
+        out += '&';
+        out += counterNames[i];
+        out += '=';
+        out += std::to_string(Counters[i].load(std::memory_order_relaxed));
+    }
+    for (size_t i = 0; i < (size_t)MetricTimer::COUNT; i++) {
+        const LatencyHistogram &timer = Timers[i];
+        if (timer.count() == 0) {
+            continue;
+        }
+        const char *name = timerNames[i];
+        out += '&'; out += name; out += "_n=";   out += std::to_string(timer.count());
+        out += '&'; out += name; out += "_avg="; out += std::to_string(timer.mean());
+        out += '&'; out += name; out += "_p99="; out += std::to_string(timer.percentile(99));
+        out += '&'; out += name; out += "_max="; out += std::to_string(timer.max());
+    }
+}
+
+void MetricsRegistry::reset() {
+    for (LatencyHistogram &timer : Timers) {
+        timer.reset();
+    }
+    for (std::atomic<uint32_t> &counter : Counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    StartTime = getMillis();
+}
+
+MetricsRegistry& getMetrics() {
+    static MetricsRegistry metrics; // Constructed on first use, safe for static initializers
+    return metrics;
+}
+
+const char* getMetricName(MetricTimer timer) {
+    return (timer < MetricTimer::COUNT) ? timerNames[(size_t)timer] : "";
+}
+
+const char* getMetricName(MetricCounter counter) {
+    return (counter < MetricCounter::COUNT) ? counterNames[(size_t)counter] : "";
+}
@@ -0,0 +1,215 @@
+/**
+ * @file metrics.hpp
+ * @brief Declaration of runtime metrics: hot-path timers, counters and latency histograms.
+ *
+ * Hot paths are measured by METRIC_SCOPE (scoped timer on monotonic clock) and METRIC_COUNT (counter),
+ * both compile to nothing without METRICS (see config.hpp). Metrics are recorded by relaxed atomics,
+ * so they can be updated from link workers and read from any core/thread.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "config.hpp"  ///< Configuration.
+#include "helpers.hpp" ///< For getMicros
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef METRICS_HISTOGRAM_BUCKETS
+    #define METRICS_HISTOGRAM_BUCKETS 24
+#endif
+
+/// Hot-path instrumentation, compiled out without METRICS (arguments are not evaluated)
+#ifdef METRICS
+    #define METRIC_SCOPE(timer) ScopedTimer metricScope(MetricTimer::timer)
+    #define METRIC_COUNT(counter, n) getMetrics().count(MetricCounter::counter, (uint32_t)(n))
+#else
+    #define METRIC_SCOPE(timer) ((void)0)
+    #define METRIC_COUNT(counter, n) ((void)0)
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * @enum MetricTimer
+ * @brief Measured hot paths.
+ */
+enum class MetricTimer : uint8_t {
+    SEND,    ///< Messenger::sendMessage / sendFrame.
+    RECEIVE, ///< Messenger::receiveMessage, including wait for the link.
+    PARSE,   ///< ParseMetadata / ParseRecord.
+    UPDATE,  ///< Applying values of update to sensor.
+    PRINT,   ///< printSensor.
+    DRAW,    ///< drawSensor (including lazy construction).
+    RESYNC,  ///< SensorManager::resync.
+    POLL,    ///< SensorManager::poll.
+    COUNT
+};
+
+/**
+ * @enum MetricCounter
+ * @brief Counted events.
+ */
+enum class MetricCounter : uint8_t {
+    MESSAGES_SENT,     ///< Sent messages and frames.
+    MESSAGES_RECEIVED, ///< Received messages and frames.
+    BYTES_SENT,        ///< Sent bytes.
+    BYTES_RECEIVED,    ///< Received bytes.
+    TIMEOUTS,          ///< Receive and request timeouts.
+    INVALID_VALUES,    ///< Updates with invalid value.
+    SYNC_CACHED,       ///< Syncs served by fresh cached values.
+    SYNC_COALESCED,    ///< Syncs merged into request already in flight.
+    COUNT
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief Histogram of durations in microseconds, bucket i holds durations in [2^i, 2^(i+1)).
+ */
+class LatencyHistogram
+{
+private:
+    std::atomic<uint32_t> Buckets[METRICS_HISTOGRAM_BUCKETS] = {}; ///< Samples per power of two bucket.
+    std::atomic<uint32_t> Count{0};  ///< Number of samples.
+    std::atomic<uint64_t> Total{0};  ///< Sum of samples.
+    std::atomic<uint32_t> Max{0};    ///< Longest sample.
+public:
+    /**
+     * @brief Record one duration.
+     *
+     * @param micros The duration in microseconds.
+     */
+    void record(uint32_t micros);
+
+    uint32_t count() const { return Count.load(std::memory_order_relaxed); }
+    uint32_t max() const { return Max.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get mean duration in microseconds.
+     */
+    uint32_t mean() const;
+
+    /**
+     * @brief Estimate percentile of durations (upper bound of bucket).
+     *
+     * @param percent The percentile (e.g. 99).
+     * @return The duration in microseconds, 0 if there are no samples.
+     */
+    uint32_t percentile(unsigned int percent) const;
+
+    void reset();
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Timers and counters of the whole application.
+ */
+class MetricsRegistry
+{
+private:
+    LatencyHistogram Timers[(size_t)MetricTimer::COUNT];            ///< Histograms of timers.
+    std::atomic<uint32_t> Counters[(size_t)MetricCounter::COUNT] = {}; ///< Counters.
+    unsigned long StartTime = getMillis();                          ///< Start of measurement.
+public:
+    void record(MetricTimer timer, uint32_t micros)
+    {
+        Timers[(size_t)timer].record(micros);
+    }
+
+    void count(MetricCounter counter, uint32_t n = 1)
+    {
+        Counters[(size_t)counter].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    const LatencyHistogram& timer(MetricTimer timer) const
+    {
+        return Timers[(size_t)timer];
+    }
+
+    uint32_t counter(MetricCounter counter) const
+    {
+        return Counters[(size_t)counter].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get time since start of measurement (or last reset) in milliseconds.
+     */
+    unsigned long uptime() const
+    {
+        return getMillis() - StartTime;
+    }
+
+    /**
+     * @brief Append metrics as key=value pairs (e.g. &sent=10&resync_n=2&resync_avg=830...).
+     *
+     * Timers are reported as name_n (count), name_avg, name_p99 and name_max in microseconds.
+     *
+     * @param out The output string.
+     */
+    void format(std::string &out) const;
+
+    void reset();
+};
+
+/**
+ * @class ScopedTimer
+ * @brief Records duration of the scope into timer of global metrics.
+ */
+class ScopedTimer
+{
+private:
+    MetricTimer Timer;   ///< Measured timer.
+    unsigned long Start; ///< Start of the scope in microseconds.
+public:
+    explicit ScopedTimer(MetricTimer timer) : Timer(timer), Start(getMicros()) {}
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+    ~ScopedTimer();
+};
+
+/*********************
+ *      DECLARES
+ *********************/
+
+/**
+ * @brief Get global metrics.
+ *
+ * @return The metrics registry.
+ */
+MetricsRegistry& getMetrics();
+
+/**
+ * @brief Get name of the timer (used as key prefix of ?STATS).
+ *
+ * @param timer The timer.
+ * @return The name.
+ */
+const char* getMetricName(MetricTimer timer);
+
+/**
+ * @brief Get name of the counter (used as key of ?STATS).
+ *
+ * @param counter The counter.
+ * @return The name.
+ */
+const char* getMetricName(MetricCounter counter);
+
+inline ScopedTimer::~ScopedTimer()
+{
+    getMetrics().record(Timer, (uint32_t)(getMicros() - Start));
+}
+
+#endif // METRICS_HPP
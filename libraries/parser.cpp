@@ -7,9 +7,9 @@
  *      INCLUDES
  *********************/
 #include "parser.hpp"
+#include "metrics.hpp" ///< For METRIC_SCOPE
 
 #include <cstdio>
-#include <algorithm> // For std::transform
 
 /**********************
  *      TYPEDEFS
@@ -18,6 +18,10 @@
 /**********************
  *     VARIABLES
  **********************/
+static constexpr uint32_t ID_KEY = hashKey("id");         ///< Hash of sensor UID key.
+static constexpr uint32_t STATUS_KEY = hashKey("status"); ///< Hash of sensor status key.
+static constexpr uint32_t SEQ_KEY = hashKey("seq");       ///< Hash of update sequence key.
+static constexpr uint32_t RID_KEY = hashKey("rid");       ///< Hash of request ID key.
 
 /*********************
  *      DEFINES
@@ -39,47 +43,79 @@ int IsValid(const SensorMetadata* metadata, const std::string &uid)
     return CheckMetadata(metadata) && metadata->UID == uid;
 }
 
-SensorMetadata ParseMetadata(std::string &response, bool caseSensitive)
+/**
+ * @brief Match tokenized key, by case-folded hash (and text on hash match) or exactly.
+ */
+static bool matchKey(const KeyValuePair &pair, std::string_view key, uint32_t hash, bool caseSensitive)
 {
-    SensorMetadata metadata;
-    metadata.UID = "";
-    metadata.Status = "";
-    metadata.Data = "";
-
-    //Check request format
-    if(response.size() < 1 || response[0] != '?')
+    if(caseSensitive)
     {
-        return metadata;
+        return pair.Key == key;
     }
+    return pair.KeyHash == hash && equalsIgnoreCase(pair.Key, key);
+}
 
-    //Get rid of the '?' character
-    response.erase(0, 1);
+SensorMetadata ParseMetadata(std::string_view response, bool caseSensitive)
+{
+    SensorMetadata metadata;
 
-    if(!caseSensitive)
+    //Check request format
+    if(response.size() < 1)
     {
-        // Convert to lowercase
-        std::transform(response.begin(), response.end(), response.begin(), ::tolower);
+        return metadata;
     }
 
-    //Parse ID from request
-    std::string uid = getValueFromKeyValueLikeString(response, "id", '&');
-    if(!uid.empty())
+    //Skip the '?' character (segments of batch response have it already stripped)
+    if(response[0] == '?')
     {
-        metadata.UID = uid;
+        response.remove_prefix(1);
     }
 
-    //Parse Status from request
-    std::string status = getValueFromKeyValueLikeString(response, "status", '&');
-    if(!status.empty())
-    {
-        metadata.Status = status;
-    }
-    
+    SensorRecord record = ParseRecord(response, caseSensitive);
+    metadata.UID.assign(record.UID.data(), record.UID.size());
+    metadata.ID = record.ID;
+    metadata.Status.assign(record.Status.data(), record.Status.size());
+    metadata.RequestID = record.RequestID;
+    metadata.Sequence = record.Sequence;
     //Save the rest of the request as data
-    metadata.Data = response;
+    metadata.Data.assign(response.data(), response.size());
 
     return metadata;
 }
 
+SensorRecord ParseRecord(std::string_view record, bool caseSensitive)
+{
+    METRIC_SCOPE(PARSE);
+    SensorRecord parsed;
+
+    //Parse ID and Status from record in single pass, keys are compared by hash computed by tokenizer
+    parsed.Data = record;
+    KeyValueTokenizer tokenizer(record, '&');
+    KeyValuePair pair;
+    while(tokenizer.next(pair))
+    {
+        if(matchKey(pair, "id", ID_KEY, caseSensitive))
+        {
+            parsed.UID = pair.Value;
+            parsed.ID = internSensorID(pair.Value);
+        }
+        else if(matchKey(pair, "status", STATUS_KEY, caseSensitive))
+        {
+            parsed.Status = pair.Value;
+        }
+        else if(matchKey(pair, "seq", SEQ_KEY, caseSensitive))
+        {
+            parseNumber(pair.Value, parsed.Sequence);
+        }
+        else if(matchKey(pair, "rid", RID_KEY, caseSensitive))
+        {
+            int rid = 0;
+            if(parseNumber(pair.Value, rid) && rid > 0)
+            {
+                parsed.RequestID = (unsigned int)rid;
+            }
+        }
+    }
 
-
+    return parsed;
+}
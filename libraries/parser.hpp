@@ -9,9 +9,12 @@
 /*********************
  *      INCLUDES
  *********************/
+#include "config.hpp"
 #include "exceptions.hpp"
 #include "helpers.hpp"
+#include <cstring>
 #include <string>
+#include <string_view>
 
 /**********************
  *      TYPEDEFS
@@ -23,8 +26,24 @@
 struct SensorMetadata
 {
   std::string UID;
+  int ID = -1;                ///< Interned integer ID of UID (see internSensorID()), -1 if not interned.
   std::string Status;
   std::string Data;
+  unsigned int RequestID = 0; ///< Request ID echoed by device (rid), 0 if not present.
+  unsigned long Sequence = 0; ///< Update sequence number of device (seq), 0 if not present.
+};
+
+/**
+ * @brief Sensor record of update response, views into parsed buffer (valid while buffer is).
+ */
+struct SensorRecord
+{
+  std::string_view UID;       ///< Sensor UID (id).
+  int ID = -1;                ///< Interned integer ID of UID (see internSensorID()), -1 if not interned.
+  std::string_view Status;    ///< Sensor status (status).
+  std::string_view Data;      ///< Whole record, values are key=value pairs.
+  unsigned int RequestID = 0; ///< Request ID echoed by device (rid), 0 if not present.
+  unsigned long Sequence = 0; ///< Update sequence number of device (seq), 0 if not present.
 };
 
 /*********************
@@ -51,10 +70,108 @@ int CheckMetadata(const SensorMetadata* metadata);
 /**
  * @brief Parse metadata from a request string.
  * 
+ * The request is not modified, keys are matched case-insensitively (values keep their case).
+ * 
  * @param response The request string to parse.
- * @param caseSensitive Flag to indicate if parsing should be case-sensitive.
+ * @param caseSensitive Flag to match metadata keys (id, status, seq, rid) case-sensitively.
  * @return The parsed metadata.
  */
-SensorMetadata ParseMetadata(std::string &request, bool caseSensitive = false);
+SensorMetadata ParseMetadata(std::string_view request, bool caseSensitive = false);
+
+/**
+ * @brief Parse one sensor record in place, without allocation and without rewriting it.
+ * 
+ * Metadata keys are matched by case-folded hash (see hashKey()), computed by tokenizer.
+ * 
+ * @param record The record without leading '?'.
+ * @param caseSensitive Flag to match metadata keys (id, status, seq, rid) case-sensitively.
+ * @return The parsed record, viewing the record buffer.
+ */
+SensorRecord ParseRecord(std::string_view record, bool caseSensitive = false);
+
+/**
+ * @brief Check if the record holds sensor data (has UID and data).
+ */
+inline bool CheckRecord(const SensorRecord &record)
+{
+    return !record.UID.empty() && !record.Data.empty();
+}
+
+/**
+ * @class UpdateStreamParser
+ * @brief Streaming parser of batched update response (?seq=..?id=..&..?id=..&..).
+ * 
+ * Response is pushed in chunks as it arrives, every complete sensor record is parsed in place
+ * (in fixed record buffer) and passed to callback, so memory stays constant for any batch size.
+ * Records longer than UART_RX_BUFFER_SIZE are dropped.
+ */
+class UpdateStreamParser
+{
+private:
+    char Record[UART_RX_BUFFER_SIZE]; ///< Record being assembled.
+    size_t Length = 0;                ///< Length of assembled record.
+    bool Overflow = false;            ///< Record does not fit into buffer, drop until next record.
+    bool CaseSensitive;               ///< Flag of case-sensitive parsing.
+
+    template <typename Callback>
+    void emit(Callback &onRecord)
+    {
+        if(Length > 0 && !Overflow)
+        {
+            onRecord(ParseRecord(std::string_view(Record, Length), CaseSensitive));
+        }
+        Length = 0;
+        Overflow = false;
+    }
+
+    void append(const char *data, size_t size)
+    {
+        if(Overflow || size > sizeof(Record) - Length)
+        {
+            Overflow = true;
+            return;
+        }
+        std::memcpy(Record + Length, data, size);
+        Length += size;
+    }
+public:
+    explicit UpdateStreamParser(bool caseSensitive = false) : CaseSensitive(caseSensitive) {}
+
+    /**
+     * @brief Push received part of response, complete records are passed to callback.
+     * 
+     * @param chunk The received part (line endings are ignored).
+     * @param onRecord The callback, called as onRecord(const SensorRecord&) for every complete record.
+     */
+    template <typename Callback>
+    void push(std::string_view chunk, Callback &&onRecord)
+    {
+        while(!chunk.empty())
+        {
+            size_t end = chunk.find_first_of("?\r\n");
+            append(chunk.data(), (end == std::string_view::npos) ? chunk.size() : end);
+            if(end == std::string_view::npos)
+            {
+                return;
+            }
+            if(chunk[end] == '?')
+            {
+                emit(onRecord);
+            }
+            chunk.remove_prefix(end + 1);
+        }
+    }
+
+    /**
+     * @brief Finish response, last record is passed to callback.
+     * 
+     * @param onRecord The callback, called as onRecord(const SensorRecord&).
+     */
+    template <typename Callback>
+    void finish(Callback &&onRecord)
+    {
+        emit(onRecord);
+    }
+};
 
 #endif //__PARSER_H_
\ No newline at end of file
@@ -0,0 +1,223 @@
+/*
+* Copyright 2025 MTA
+* Author: Ing. Jiri Konecny
+*/
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "protocol.hpp"
+
+#include <cstring> // For std::memcpy
+
+/**********************
+ *     VARIABLES
+ **********************/
+static bool binaryProtocol = false; ///< Negotiated protocol.
+
+/*********************
+ *      DEFINES
+ *********************/
+
+static void storeLittleEndian(uint8_t *out, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint64_t loadLittleEndian(const uint8_t *in, size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        value |= (uint64_t)in[i] << (8 * i);
+    }
+    return value;
+}
+
+uint8_t crc8(const uint8_t *data, size_t size)
+{
+    uint8_t crc = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+BinaryFrameWriter::BinaryFrameWriter(ProtocolCommand command, uint8_t sensorId, int8_t status, bool response)
+: Length(PROTOCOL_HEADER_SIZE), Overflow(false)
+{
+    Buffer[0] = PROTOCOL_SYNC;
+    Buffer[1] = 0;
+    Buffer[Length++] = (uint8_t)command | (response ? PROTOCOL_RESPONSE : 0);
+    Buffer[Length++] = sensorId;
+    Buffer[Length++] = (uint8_t)status;
+}
+
+bool BinaryFrameWriter::write(const void *data, size_t size)
+{
+    // Keep one byte for CRC
+    if (Overflow || Length + size + 1 > sizeof(Buffer))
+    {
+        Overflow = true;
+        return false;
+    }
+
+    std::memcpy(Buffer + Length, data, size);
+    Length += size;
+    return true;
+}
+
+bool BinaryFrameWriter::writeHeader(uint8_t slot, ProtocolType type)
+{
+    uint8_t header[2] = {slot, (uint8_t)type};
+    return write(header, sizeof(header));
+}
+
+bool BinaryFrameWriter::addInt(uint8_t slot, int32_t value)
+{
+    uint8_t payload[4];
+    storeLittleEndian(payload, (uint32_t)value, sizeof(payload));
+    return writeHeader(slot, ProtocolType::INT) && write(payload, sizeof(payload));
+}
+
+bool BinaryFrameWriter::addFloat(uint8_t slot, float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint8_t payload[4];
+    storeLittleEndian(payload, bits, sizeof(payload));
+    return writeHeader(slot, ProtocolType::FLOAT) && write(payload, sizeof(payload));
+}
+
+bool BinaryFrameWriter::addDouble(uint8_t slot, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint8_t payload[8];
+    storeLittleEndian(payload, bits, sizeof(payload));
+    return writeHeader(slot, ProtocolType::DOUBLE) && write(payload, sizeof(payload));
+}
+
+bool BinaryFrameWriter::addText(uint8_t slot, std::string_view value)
+{
+    if (value.size() > 0xFF)
+    {
+        Overflow = true;
+        return false;
+    }
+
+    uint8_t length = (uint8_t)value.size();
+    return writeHeader(slot, ProtocolType::STRING) && write(&length, 1) && write(value.data(), value.size());
+}
+
+std::string_view BinaryFrameWriter::finish()
+{
+    if (Overflow)
+    {
+        return std::string_view();
+    }
+
+    Buffer[1] = (uint8_t)(Length - PROTOCOL_HEADER_SIZE);
+    Buffer[Length] = crc8(Buffer + 1, Length - 1);
+    return std::string_view((const char *)Buffer, Length + 1);
+}
+
+bool BinaryParamReader::next(BinaryParam &param)
+{
+    if (Rest.size() < 2)
+    {
+        return false;
+    }
+
+    const uint8_t *data = (const uint8_t *)Rest.data();
+    param.Slot = data[0];
+    param.Type = (ProtocolType)data[1];
+    size_t size = 0;
+    switch (param.Type)
+    {
+    case ProtocolType::INT:
+        size = 4;
+        if (Rest.size() < 2 + size) return false;
+        param.Number.Int = (int32_t)(uint32_t)loadLittleEndian(data + 2, size);
+        break;
+    case ProtocolType::FLOAT:
+    {
+        size = 4;
+        if (Rest.size() < 2 + size) return false;
+        uint32_t bits = (uint32_t)loadLittleEndian(data + 2, size);
+        std::memcpy(&param.Number.Float, &bits, sizeof(bits));
+        break;
+    }
+    case ProtocolType::DOUBLE:
+    {
+        size = 8;
+        if (Rest.size() < 2 + size) return false;
+        uint64_t bits = loadLittleEndian(data + 2, size);
+        std::memcpy(&param.Number.Double, &bits, sizeof(bits));
+        break;
+    }
+    case ProtocolType::STRING:
+        if (Rest.size() < 3 || Rest.size() < 3 + (size_t)data[2]) return false;
+        size = 1 + (size_t)data[2];
+        param.Text = Rest.substr(3, data[2]);
+        break;
+    default:
+        return false;
+    }
+
+    Rest.remove_prefix(2 + size);
+    return true;
+}
+
+bool isBinaryFrame(std::string_view message)
+{
+    return !message.empty() && (uint8_t)message[0] == PROTOCOL_SYNC;
+}
+
+bool decodeFrame(std::string_view message, BinaryFrame &frame)
+{
+    if (!isBinaryFrame(message) || message.size() < PROTOCOL_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    const uint8_t *data = (const uint8_t *)message.data();
+    size_t length = data[1];
+    if (length < 3 || message.size() != PROTOCOL_HEADER_SIZE + length + 1)
+    {
+        return false;
+    }
+    if (crc8(data + 1, length + 1) != data[PROTOCOL_HEADER_SIZE + length])
+    {
+        return false;
+    }
+
+    frame.Command = (ProtocolCommand)(data[2] & ~PROTOCOL_RESPONSE);
+    frame.Response = (data[2] & PROTOCOL_RESPONSE) != 0;
+    frame.SensorID = data[3];
+    frame.Status = (int8_t)data[4];
+    frame.Params = message.substr(5, length - 3);
+    return true;
+}
+
+bool isBinaryProtocol()
+{
+    return binaryProtocol;
+}
+
+void setBinaryProtocol(bool binary)
+{
+    #ifdef PROTOCOL_BINARY
+        binaryProtocol = binary;
+    #else
+        (void)binary;
+    #endif
+}
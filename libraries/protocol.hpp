@@ -0,0 +1,201 @@
+/**
+ * @file protocol.hpp
+ * @brief Declaration of the compact binary wire protocol.
+ *
+ * This header declares encoder and decoder of binary frames, an alternative to the text
+ * ?CMD&id=..&key=value messages. Binary protocol is enabled by PROTOCOL_BINARY in config.hpp
+ * and used only if the device accepts it during negotiation, text protocol stays as fallback.
+ *
+ * Frame layout:
+ * [SYNC][LEN][CMD][ID][STATUS]{[SLOT][TYPE][payload]}*[CRC8]
+ * - LEN: number of bytes from CMD to the last parameter.
+ * - CMD: command code, PROTOCOL_RESPONSE bit is set for device responses.
+ * - ID: compact sensor ID, PROTOCOL_BROADCAST_ID for all sensors (or end of batch response).
+ * - SLOT: parameter index in order of sensor parameters declaration.
+ * - payload: INT int32, FLOAT float32, DOUBLE float64 (little endian), STRING [length][bytes].
+ * - CRC8: polynomial 0x07 over LEN..last parameter.
+ *
+ * @copyright 2025 MTA
+ * @author
+ * Ing. Jiri Konecny
+ */
+
+#ifndef PROTOCOL_HPP
+#define PROTOCOL_HPP
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PROTOCOL_SYNC 0xA5          ///< First byte of binary frame (never starts text message).
+#define PROTOCOL_RESPONSE 0x80      ///< Command flag of device response.
+#define PROTOCOL_BROADCAST_ID 0xFF  ///< Sensor ID addressing all sensors.
+#define PROTOCOL_HEADER_SIZE 2      ///< SYNC and LEN bytes.
+#define PROTOCOL_MAX_FRAME (PROTOCOL_HEADER_SIZE + 255 + 1) ///< Maximal frame size.
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * @enum ProtocolCommand
+ * @brief Binary command codes.
+ */
+enum class ProtocolCommand : uint8_t
+{
+    CONFIG = 0x01,
+    UPDATE = 0x02,
+    INIT = 0x03,
+    RESET = 0x04
+};
+
+/**
+ * @enum ProtocolType
+ * @brief Binary payload types, same order as DataType.
+ */
+enum class ProtocolType : uint8_t
+{
+    INT = 0,
+    DOUBLE = 1,
+    FLOAT = 2,
+    STRING = 3
+};
+
+/**
+ * @brief Decoded binary frame, payload views into the source buffer.
+ */
+struct BinaryFrame
+{
+    ProtocolCommand Command;  ///< Command code (without response flag).
+    bool Response;            ///< Frame is device response.
+    uint8_t SensorID;         ///< Compact sensor ID.
+    int8_t Status;            ///< Sensor status (as SensorStatus).
+    std::string_view Params;  ///< Encoded parameters.
+};
+
+/**
+ * @brief Decoded binary parameter.
+ */
+struct BinaryParam
+{
+    uint8_t Slot;       ///< Parameter index.
+    ProtocolType Type;  ///< Payload type.
+    union
+    {
+        int32_t Int;
+        float Float;
+        double Double;
+    } Number;               ///< Numerical payload.
+    std::string_view Text;  ///< STRING payload.
+};
+
+/**
+ * @class BinaryFrameWriter
+ * @brief Encodes binary frame into internal fixed buffer, without allocation.
+ */
+class BinaryFrameWriter
+{
+private:
+    uint8_t Buffer[PROTOCOL_MAX_FRAME]; ///< Frame buffer.
+    size_t Length;                      ///< Used bytes.
+    bool Overflow;                      ///< Frame does not fit into buffer.
+
+    bool write(const void *data, size_t size);
+    bool writeHeader(uint8_t slot, ProtocolType type);
+public:
+    /**
+     * @brief Constructs a new BinaryFrameWriter object and writes frame header.
+     *
+     * @param command The command code.
+     * @param sensorId The compact sensor ID.
+     * @param status The sensor status.
+     * @param response Flag to mark frame as response.
+     */
+    BinaryFrameWriter(ProtocolCommand command, uint8_t sensorId, int8_t status = 0, bool response = false);
+
+    bool addInt(uint8_t slot, int32_t value);
+    bool addFloat(uint8_t slot, float value);
+    bool addDouble(uint8_t slot, double value);
+    bool addText(uint8_t slot, std::string_view value);
+
+    /**
+     * @brief Finish frame, fill length and CRC.
+     *
+     * @return The view of encoded frame, empty if parameters did not fit.
+     */
+    std::string_view finish();
+};
+
+/**
+ * @class BinaryParamReader
+ * @brief Reads parameters of decoded binary frame one by one.
+ */
+class BinaryParamReader
+{
+private:
+    std::string_view Rest; ///< Rest of encoded parameters.
+public:
+    BinaryParamReader(std::string_view params) : Rest(params) {}
+
+    /**
+     * @brief Read next parameter.
+     *
+     * @param param The output parameter.
+     * @return true if parameter was read, false at the end or on malformed data.
+     */
+    bool next(BinaryParam &param);
+};
+
+/*********************
+ *      DECLARES
+ *********************/
+
+/**
+ * @brief Compute CRC-8 (polynomial 0x07).
+ *
+ * @param data The data.
+ * @param size The data size.
+ * @return The CRC.
+ */
+uint8_t crc8(const uint8_t *data, size_t size);
+
+/**
+ * @brief Check if message is binary frame.
+ *
+ * @param message The received message.
+ * @return true if message starts with PROTOCOL_SYNC.
+ */
+bool isBinaryFrame(std::string_view message);
+
+/**
+ * @brief Decode binary frame.
+ *
+ * @param message The received message.
+ * @param frame The decoded frame, views into message.
+ * @return true if frame is complete and CRC matches, false otherwise.
+ */
+bool decodeFrame(std::string_view message, BinaryFrame &frame);
+
+/**
+ * @brief Check if binary protocol was negotiated.
+ *
+ * @return true if binary protocol is used, false for text protocol.
+ */
+bool isBinaryProtocol();
+
+/**
+ * @brief Set negotiated protocol, has no effect if PROTOCOL_BINARY is not defined.
+ *
+ * @param binary Flag to use binary protocol.
+ */
+void setBinaryProtocol(bool binary);
+
+#endif // PROTOCOL_HPP
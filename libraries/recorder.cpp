@@ -0,0 +1,315 @@
+/*
+* Copyright 2025 MTA
+* Author: Ing. Jiri Konecny
+*/
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "recorder.hpp"
+
+#include <cstring>
+
+#ifdef ARDUINO_H
+    #include <esp_partition.h> ///< ESP32 flash partitions
+#elif defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>    ///< For open
+    #include <sys/mman.h> ///< For mmap
+    #include <sys/stat.h> ///< For fstat
+    #include <unistd.h>   ///< For ftruncate, close
+#endif
+
+/**
+ * @brief Check header of reading log.
+ */
+static bool isValidHeader(const ReadingLogHeader &header) {
+    return std::memcmp(header.Magic, READING_LOG_MAGIC, sizeof(header.Magic)) == 0 &&
+           header.Version == READING_LOG_VERSION && header.RecordSize == sizeof(ReadingRecord) &&
+           header.Count <= header.Capacity;
+}
+
+/**
+ * @brief Initialize header of empty reading log.
+ */
+static void initHeader(ReadingLogHeader &header, size_t capacity) {
+    std::memcpy(header.Magic, READING_LOG_MAGIC, sizeof(header.Magic));
+    header.Version = READING_LOG_VERSION;
+    header.RecordSize = sizeof(ReadingRecord);
+    header.Capacity = (uint32_t)capacity;
+    header.Count = 0;
+}
+
+#ifdef ARDUINO_H
+    #define RECORDER_SECTOR_SIZE 4096 ///< Flash erase unit in bytes.
+    #define RECORDS_PER_SECTOR (RECORDER_SECTOR_SIZE / sizeof(ReadingRecord))
+
+    /**
+     * @brief Get opened partition.
+     */
+    static inline const esp_partition_t* partition(const void *handle) {
+        return (const esp_partition_t*)handle;
+    }
+
+    bool FlashReadingRing::isErased(size_t index) const {
+        uint32_t time = 0;
+        esp_partition_read(partition(Partition), index * sizeof(ReadingRecord), &time, sizeof(time));
+        return time == 0xFFFFFFFF;
+    }
+
+    bool FlashReadingRing::open() {
+        Partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, Label);
+        if (Partition == nullptr) {
+            return false;
+        }
+        Capacity = (partition(Partition)->size / RECORDER_SECTOR_SIZE) * RECORDS_PER_SECTOR;
+        if (Capacity < 2 * RECORDS_PER_SECTOR) {
+            Partition = nullptr;
+            return false;
+        }
+
+        // Record at write position is always erased, head is the first erased record after written one
+        Head = 0;
+        bool found = false;
+        bool previous = !isErased(Capacity - 1);
+        for (size_t i = 0; i < Capacity && !found; i++) {
+            bool erased = isErased(i);
+            if (erased && previous) {
+                Head = i;
+                found = true;
+            }
+            previous = !erased;
+        }
+        if (!found && previous) {
+            // Power loss before erase of next sector, the oldest sector is dropped
+            esp_partition_erase_range(partition(Partition), 0, RECORDER_SECTOR_SIZE);
+        }
+        // Written sector after head sector means the ring was overwritten
+        size_t next = ((Head / RECORDS_PER_SECTOR + 1) * RECORDS_PER_SECTOR) % Capacity;
+        Wrapped = !isErased(next);
+        return true;
+    }
+
+    size_t FlashReadingRing::size() const {
+        if (Partition == nullptr) {
+            return 0;
+        }
+        // Rest of head sector is erased
+        return Wrapped ? Capacity - RECORDS_PER_SECTOR + (Head % RECORDS_PER_SECTOR) : Head;
+    }
+
+    bool FlashReadingRing::read(size_t index, ReadingRecord &record) const {
+        size_t count = size();
+        if (index >= count) {
+            return false;
+        }
+        size_t position = (Head + Capacity - count + index) % Capacity;
+        return esp_partition_read(partition(Partition), position * sizeof(ReadingRecord), &record, sizeof(record)) == ESP_OK;
+    }
+
+    size_t FlashReadingRing::append(const ReadingRecord *records, size_t count) {
+        if (Partition == nullptr) {
+            return 0;
+        }
+        size_t written = 0;
+        while (written < count) {
+            // Write up to the end of current sector
+            size_t chunk = RECORDS_PER_SECTOR - (Head % RECORDS_PER_SECTOR);
+            if (chunk > count - written) {
+                chunk = count - written;
+            }
+            if (esp_partition_write(partition(Partition), Head * sizeof(ReadingRecord), records + written, chunk * sizeof(ReadingRecord)) != ESP_OK) {
+                break;
+            }
+            written += chunk;
+            Head = (Head + chunk) % Capacity;
+            if (Head % RECORDS_PER_SECTOR == 0) {
+                // Erase next sector before writing into it, oldest records are dropped
+                Wrapped |= (Head == 0);
+                esp_partition_erase_range(partition(Partition), Head * sizeof(ReadingRecord), RECORDER_SECTOR_SIZE);
+            }
+        }
+        return written;
+    }
+#else
+    MappedReadingLog::~MappedReadingLog() {
+        close();
+    }
+
+    #if defined(__unix__) || defined(__APPLE__)
+        bool MappedReadingLog::open() {
+            if (Header != nullptr) {
+                return true;
+            }
+            File = ::open(Path.c_str(), O_RDWR | O_CREAT, 0644);
+            if (File < 0) {
+                return false;
+            }
+
+            Size = sizeof(ReadingLogHeader) + Capacity * sizeof(ReadingRecord);
+            struct stat status;
+            bool existing = fstat(File, &status) == 0 && (size_t)status.st_size >= sizeof(ReadingLogHeader);
+            if ((existing && (size_t)status.st_size < Size) || !existing) {
+                // Preallocate whole log, so appending does not grow the file
+                #ifdef __linux__
+                    bool allocated = posix_fallocate(File, 0, (off_t)Size) == 0;
+                #else
+                    bool allocated = false;
+                #endif
+                if (!allocated && ftruncate(File, (off_t)Size) != 0) {
+                    ::close(File);
+                    File = -1;
+                    return false;
+                }
+            } else {
+                Size = (size_t)status.st_size;
+            }
+
+            void *memory = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, File, 0);
+            if (memory == MAP_FAILED) {
+                ::close(File);
+                File = -1;
+                return false;
+            }
+            Header = (ReadingLogHeader*)memory;
+            if (!existing || !isValidHeader(*Header)) {
+                initHeader(*Header, Capacity);
+            }
+            // Capacity of continued log can be larger than requested
+            Capacity = (Size - sizeof(ReadingLogHeader)) / sizeof(ReadingRecord);
+            Header->Capacity = (uint32_t)Capacity;
+            return true;
+        }
+
+        void MappedReadingLog::close() {
+            if (Header == nullptr) {
+                return;
+            }
+            msync(Header, Size, MS_SYNC);
+            munmap(Header, Size);
+            ::close(File);
+            Header = nullptr;
+            File = -1;
+        }
+
+        size_t MappedReadingLog::append(const ReadingRecord *records, size_t count) {
+            if (Header == nullptr) {
+                return 0;
+            }
+            size_t free = Capacity - Header->Count;
+            if (count > free) {
+                count = free;
+            }
+            ReadingRecord *target = (ReadingRecord*)(Header + 1) + Header->Count;
+            std::memcpy(target, records, count * sizeof(ReadingRecord));
+            Header->Count += (uint32_t)count;
+            return count;
+        }
+
+        void MappedReadingLog::flush() {
+            if (Header != nullptr) {
+                msync(Header, Size, MS_ASYNC); // Page cache is written by kernel, no blocking on hot path
+            }
+        }
+    #else
+        bool MappedReadingLog::open() {
+            if (Header != nullptr) {
+                return true;
+            }
+            File = fopen(Path.c_str(), "r+b");
+            if (File != nullptr && fread(&State, sizeof(State), 1, File) == 1 && isValidHeader(State)) {
+                Capacity = State.Capacity;
+            } else {
+                if (File != nullptr) {
+                    fclose(File);
+                }
+                File = fopen(Path.c_str(), "w+b");
+                if (File == nullptr) {
+                    return false;
+                }
+                initHeader(State, Capacity);
+                fwrite(&State, sizeof(State), 1, File);
+            }
+            Header = &State;
+            return true;
+        }
+
+        void MappedReadingLog::close() {
+            if (Header == nullptr) {
+                return;
+            }
+            flush();
+            fclose(File);
+            File = nullptr;
+            Header = nullptr;
+        }
+
+        size_t MappedReadingLog::append(const ReadingRecord *records, size_t count) {
+            if (Header == nullptr) {
+                return 0;
+            }
+            size_t free = Capacity - State.Count;
+            if (count > free) {
+                count = free;
+            }
+            fseek(File, (long)(sizeof(ReadingLogHeader) + State.Count * sizeof(ReadingRecord)), SEEK_SET);
+            count = fwrite(records, sizeof(ReadingRecord), count, File);
+            State.Count += (uint32_t)count;
+            return count;
+        }
+
+        void MappedReadingLog::flush() {
+            if (Header != nullptr) {
+                fseek(File, 0, SEEK_SET);
+                fwrite(&State, sizeof(State), 1, File);
+                fflush(File);
+            }
+        }
+    #endif
+
+    ReadingLogReader::~ReadingLogReader() {
+        if (File != nullptr) {
+            fclose(File);
+        }
+    }
+
+    bool ReadingLogReader::open(const std::string &path) {
+        if (File != nullptr) {
+            fclose(File);
+        }
+        Index = 0;
+        File = fopen(path.c_str(), "rb");
+        if (File == nullptr) {
+            return false;
+        }
+        if (fread(&Header, sizeof(Header), 1, File) != 1 || !isValidHeader(Header)) {
+            fclose(File);
+            File = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    bool ReadingLogReader::next(ReadingRecord &record) {
+        if (File == nullptr || Index >= Header.Count || fread(&record, sizeof(record), 1, File) != 1) {
+            return false;
+        }
+        Index++;
+        return true;
+    }
+#endif
+
+ReadingRecorder& getRecorder() {
+    // Constructed on first use, safe for static initializers
+    static ReadingRecorder recorder;
+    return recorder;
+}
+
+ReadingSink* getDefaultReadingLog() {
+    #ifdef ARDUINO_H
+        static FlashReadingRing log;
+    #else
+        static MappedReadingLog log;
+    #endif
+    static bool opened = log.open();
+    return opened ? &log : nullptr;
+}
@@ -0,0 +1,411 @@
+/**
+ * @file recorder.hpp
+ * @brief Declaration of binary recorder of sensor readings (append-only log for later analysis).
+ *
+ * Every value committed by sensor update is recorded as fixed 16 B record (timestamp, sensor handle,
+ * parameter slot, typed value). Records are buffered by the recorder and written in batches into the sink:
+ * memory-mapped preallocated file on Linux/PC or ring in flash partition on Arduino (ESP32).
+ * Recording is compiled only with RECORDER (see config.hpp).
+ *
+ * Log file layout: ReadingLogHeader followed by Count records (little endian, as written by the host).
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef RECORDER_HPP
+#define RECORDER_HPP
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "config.hpp"   ///< Configuration.
+#include "protocol.hpp" ///< For ProtocolType
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef RECORDER_BUFFER_SIZE
+    #define RECORDER_BUFFER_SIZE 64
+#endif
+
+#ifndef RECORDER_FILE
+    #define RECORDER_FILE "readings.bin"
+#endif
+
+/// Number of records preallocated in log file (16 MiB)
+#ifndef RECORDER_CAPACITY
+    #define RECORDER_CAPACITY 1048576
+#endif
+
+#ifndef RECORDER_PARTITION
+    #define RECORDER_PARTITION "readings"
+#endif
+
+#define READING_NO_SENSOR 0xFFFF ///< Sensor handle of sensors without numerical UID (or with UID >= READING_NO_SENSOR).
+#define READING_LOG_MAGIC "SRLG" ///< Magic of reading log file.
+#define READING_LOG_VERSION 1    ///< Version of reading log format.
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * @struct ReadingRecord
+ * @brief One recorded value.
+ */
+struct ReadingRecord
+{
+    uint32_t Time;   ///< Time of update in milliseconds (see getMillis()).
+    uint16_t Sensor; ///< Sensor handle (numerical sensor UID, see readingSensorHandle()).
+    uint8_t Slot;    ///< Parameter slot (index of value in sensor schema).
+    uint8_t Type;    ///< Value type (ProtocolType INT, FLOAT or DOUBLE).
+    union
+    {
+        int32_t Int;    ///< Value of INT parameter.
+        float Float;    ///< Value of FLOAT parameter.
+        double Double;  ///< Value of DOUBLE parameter.
+    } Value;            ///< Recorded value.
+
+    /**
+     * @brief Get recorded value as double.
+     */
+    double asDouble() const
+    {
+        switch ((ProtocolType)Type)
+        {
+        case ProtocolType::INT:
+            return Value.Int;
+        case ProtocolType::FLOAT:
+            return Value.Float;
+        default:
+            return Value.Double;
+        }
+    }
+};
+static_assert(sizeof(ReadingRecord) == 16, "ReadingRecord layout is part of log format");
+
+/**
+ * @struct ReadingLogHeader
+ * @brief Header of reading log file.
+ */
+struct ReadingLogHeader
+{
+    char Magic[4];       ///< READING_LOG_MAGIC.
+    uint16_t Version;    ///< READING_LOG_VERSION.
+    uint16_t RecordSize; ///< Size of record in bytes.
+    uint32_t Capacity;   ///< Number of preallocated records.
+    uint32_t Count;      ///< Number of written records.
+};
+static_assert(sizeof(ReadingLogHeader) == 16, "ReadingLogHeader layout is part of log format");
+
+/**
+ * @class ReadingSink
+ * @brief Storage of recorded readings.
+ */
+class ReadingSink
+{
+public:
+    virtual ~ReadingSink() {}
+
+    /**
+     * @brief Append records.
+     *
+     * @param records The records.
+     * @param count The number of records.
+     * @return Number of stored records (less than count if storage is full).
+     */
+    virtual size_t append(const ReadingRecord *records, size_t count) = 0;
+
+    /**
+     * @brief Write stored records through to the storage.
+     */
+    virtual void flush() {}
+};
+
+#ifdef ARDUINO_H
+    /**
+     * @class FlashReadingRing
+     * @brief Readings stored in ring over flash data partition (ESP32), oldest sector is erased when full.
+     *
+     * Write position is found on open by scanning for the first erased record, so the ring survives restart.
+     */
+    class FlashReadingRing : public ReadingSink
+    {
+    private:
+        const char *Label;             ///< Partition label.
+        const void *Partition = nullptr; ///< Opened partition (esp_partition_t).
+        size_t Capacity = 0;           ///< Number of records in partition.
+        size_t Head = 0;               ///< Index of next written record.
+        bool Wrapped = false;          ///< Ring was already overwritten.
+
+        bool isErased(size_t index) const;
+    public:
+        explicit FlashReadingRing(const char *label = RECORDER_PARTITION) : Label(label) {}
+
+        /**
+         * @brief Open partition and find write position.
+         *
+         * @return true if partition was found.
+         */
+        bool open();
+
+        /**
+         * @brief Get number of stored records.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Read stored record, oldest first (e.g. to dump it over UART).
+         *
+         * @param index The index of record (0 is the oldest).
+         * @param record The output record.
+         * @return true if record was read.
+         */
+        bool read(size_t index, ReadingRecord &record) const;
+
+        size_t append(const ReadingRecord *records, size_t count) override;
+    };
+#else
+    /**
+     * @class MappedReadingLog
+     * @brief Readings appended into preallocated log file, memory-mapped on POSIX systems.
+     *
+     * Existing log with the same format is continued, records over capacity are dropped.
+     */
+    class MappedReadingLog : public ReadingSink
+    {
+    private:
+        std::string Path;                   ///< File path.
+        size_t Capacity;                    ///< Number of preallocated records.
+        ReadingLogHeader *Header = nullptr; ///< Mapped header (or in-memory copy without mmap).
+        #if defined(__unix__) || defined(__APPLE__)
+            int File = -1;                  ///< File descriptor.
+            size_t Size = 0;                ///< Mapped size in bytes.
+        #else
+            FILE *File = nullptr;           ///< Opened file.
+            ReadingLogHeader State;         ///< Header written by flush().
+        #endif
+    public:
+        explicit MappedReadingLog(const std::string &path = RECORDER_FILE, size_t capacity = RECORDER_CAPACITY) : Path(path), Capacity(capacity) {}
+        ~MappedReadingLog();
+
+        MappedReadingLog(const MappedReadingLog&) = delete;
+        MappedReadingLog& operator=(const MappedReadingLog&) = delete;
+
+        /**
+         * @brief Open (create and preallocate) the log file.
+         *
+         * @return true if log is ready.
+         */
+        bool open();
+
+        /**
+         * @brief Close the log file, written records are kept.
+         */
+        void close();
+
+        /**
+         * @brief Get number of written records.
+         */
+        size_t size() const
+        {
+            return (Header != nullptr) ? Header->Count : 0;
+        }
+
+        size_t append(const ReadingRecord *records, size_t count) override;
+        void flush() override;
+    };
+
+    /**
+     * @class ReadingLogReader
+     * @brief Sequential reader of reading log file (exporter and replay).
+     */
+    class ReadingLogReader
+    {
+    private:
+        FILE *File = nullptr;     ///< Opened file.
+        ReadingLogHeader Header;  ///< Log header.
+        size_t Index = 0;         ///< Index of next read record.
+    public:
+        ReadingLogReader() = default;
+        ~ReadingLogReader();
+
+        ReadingLogReader(const ReadingLogReader&) = delete;
+        ReadingLogReader& operator=(const ReadingLogReader&) = delete;
+
+        /**
+         * @brief Open log file and check its header.
+         *
+         * @param path The file path.
+         * @return true if file is valid reading log.
+         */
+        bool open(const std::string &path);
+
+        /**
+         * @brief Get number of records in log.
+         */
+        size_t size() const
+        {
+            return (File != nullptr) ? Header.Count : 0;
+        }
+
+        /**
+         * @brief Read next record.
+         *
+         * @param record The output record.
+         * @return true if record was read, false at the end of log.
+         */
+        bool next(ReadingRecord &record);
+    };
+#endif
+
+/**
+ * @class ReadingRecorder
+ * @brief Buffer of recorded readings, written into sink in batches.
+ *
+ * Records of link workers of parallel resync are serialized by lock (uncontended with single link).
+ */
+class ReadingRecorder
+{
+private:
+    std::mutex Lock;                              ///< Lock of buffer and sink.
+    ReadingSink *Sink = nullptr;                  ///< Storage, nullptr if recording is stopped.
+    ReadingRecord Buffer[RECORDER_BUFFER_SIZE];   ///< Records waiting for write.
+    size_t Count = 0;                             ///< Number of buffered records.
+    uint32_t Recorded = 0;                        ///< Number of stored records.
+    uint32_t Dropped = 0;                         ///< Number of records not stored (sink is full).
+public:
+    /**
+     * @brief Set storage of readings, buffered readings are written into previous sink.
+     *
+     * @param sink The sink (must outlive recording), nullptr to stop recording.
+     */
+    void setSink(ReadingSink *sink)
+    {
+        std::lock_guard<std::mutex> lock(Lock);
+        write();
+        Sink = sink;
+    }
+
+    /**
+     * @brief Check if readings are recorded.
+     */
+    bool isActive() const
+    {
+        return Sink != nullptr;
+    }
+
+    /**
+     * @brief Record reading, batch is written when buffer is full.
+     *
+     * @param record The reading.
+     */
+    void record(const ReadingRecord &record)
+    {
+        std::lock_guard<std::mutex> lock(Lock);
+        if(Sink == nullptr)
+        {
+            return;
+        }
+        Buffer[Count++] = record;
+        if(Count == RECORDER_BUFFER_SIZE)
+        {
+            write();
+        }
+    }
+
+    /**
+     * @brief Write buffered readings into the sink.
+     */
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock(Lock);
+        write();
+    }
+
+    /**
+     * @brief Get number of stored readings.
+     */
+    uint32_t recorded() const
+    {
+        return Recorded;
+    }
+
+    /**
+     * @brief Get number of readings dropped because the sink was full.
+     */
+    uint32_t dropped() const
+    {
+        return Dropped;
+    }
+private:
+    /**
+     * @brief Write buffered readings into the sink (lock is held).
+     */
+    void write()
+    {
+        if(Count == 0 || Sink == nullptr)
+        {
+            Count = 0;
+            return;
+        }
+        size_t stored = Sink->append(Buffer, Count);
+        Recorded += (uint32_t)stored;
+        Dropped += (uint32_t)(Count - stored);
+        Count = 0;
+        Sink->flush();
+    }
+};
+
+/*********************
+ *      DECLARES
+ *********************/
+
+/**
+ * @brief Get sensor handle of records, canonical numerical UID below READING_NO_SENSOR (e.g. "999" is 999).
+ *
+ * Unlike interned IDs (SENSOR_MAX_ID), handle covers every numerical sensor of large buses.
+ *
+ * @param uid The unique sensor identifier.
+ * @return The handle or READING_NO_SENSOR if UID is not numerical (or out of range).
+ */
+inline uint16_t readingSensorHandle(std::string_view uid)
+{
+    if (uid.empty() || uid.size() > 5 || (uid.size() > 1 && uid[0] == '0'))
+    {
+        return READING_NO_SENSOR;
+    }
+    uint32_t handle = 0;
+    for (char c : uid)
+    {
+        if (c < '0' || c > '9')
+        {
+            return READING_NO_SENSOR;
+        }
+        handle = handle * 10 + (uint32_t)(c - '0');
+    }
+    return (handle < READING_NO_SENSOR) ? (uint16_t)handle : READING_NO_SENSOR;
+}
+
+/**
+ * @brief Get the global readings recorder (without sink until setSink() or RECORDER default).
+ *
+ * @return The recorder.
+ */
+ReadingRecorder& getRecorder();
+
+/**
+ * @brief Get the default readings log (flash ring on Arduino, RECORDER_FILE otherwise), opened on first use.
+ *
+ * @return The sink or nullptr if it can not be opened.
+ */
+ReadingSink* getDefaultReadingLog();
+
+#endif // RECORDER_HPP
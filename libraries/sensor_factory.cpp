@@ -10,57 +10,203 @@
 
 #include "sensor_factory.hpp"
 
-void createSensorList(std::vector<BaseSensor*> &memory)
+#include <algorithm> // For std::count, std::remove
+
+void createSensorList(std::vector<BaseSensor*> &memory, MemoryArena *arena)
 {
     memory.clear();
     //Add sensors here
-    memory.push_back(new ADC("0"));
-    memory.push_back(new ADC("1"));
-    memory.push_back(new TH("2"));
+    memory.push_back(createSensor<ADC>("0", arena));
+    memory.push_back(createSensor<ADC>("1", arena));
+    memory.push_back(createSensor<TH>("2", arena));
 }
 
-void createSensorList(std::vector<BaseSensor*> &memory, std::string stringSource)
+/**
+ * @brief Registered sensor type.
+ */
+struct SensorTypeEntry
 {
-    memory.clear();
-    //Expected format: ?0:ADC&1:ADC&2:TH
-    std::vector<std::string> sensorList = splitString(stringSource, '&');
-    logMessage("\t(i)Found %d sensors...\n", sensorList.size());
-    std::string id;
-    std::string type;
-    BaseSensor* sensor;
+    uint32_t Hash;                 ///< Hash of type tag.
+    std::string_view Tag;          ///< Type tag.
+    SensorConstructor Constructor; ///< Constructor, nullptr for empty slot.
+    SensorBulkConstructor Bulk;    ///< Bulk constructor, nullptr if type has none.
+};
 
-    for (std::string sensorStr: sensorList)
+/**
+ * @brief Get registry table (open addressing, load factor <= 0.5).
+ * 
+ * Function-local static, so registration from static initializers of other units is safe.
+ */
+static SensorTypeEntry* getRegistry()
+{
+    static SensorTypeEntry registry[2 * SENSOR_TYPES_MAX] = {};
+    return registry;
+}
+
+static size_t registeredTypes = 0; ///< Number of registered types (zero-initialized before any static constructor).
+
+bool registerSensorType(std::string_view tag, SensorConstructor constructor, SensorBulkConstructor bulk)
+{
+    if (constructor == nullptr || registeredTypes >= SENSOR_TYPES_MAX)
     {
-        logMessage("\tProcessing sensor request: %s\n", sensorStr.c_str());
-        if (sensorStr.empty())
+        return false;
+    }
+
+    SensorTypeEntry* registry = getRegistry();
+    uint32_t hash = hashTypeTag(tag);
+    for (size_t i = 0, slot = hash % (2 * SENSOR_TYPES_MAX); i < 2 * SENSOR_TYPES_MAX; i++, slot = (slot + 1) % (2 * SENSOR_TYPES_MAX))
+    {
+        if (registry[slot].Constructor == nullptr)
+        {
+            registry[slot] = {hash, tag, constructor, bulk};
+            registeredTypes++;
+            return true;
+        }
+        if (registry[slot].Hash == hash && registry[slot].Tag == tag)
+        {
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Find registered sensor type.
+ * 
+ * @return The registry entry or nullptr if type is unknown.
+ */
+static const SensorTypeEntry* findEntry(std::string_view tag)
+{
+    SensorTypeEntry* registry = getRegistry();
+    uint32_t hash = hashTypeTag(tag);
+    for (size_t i = 0, slot = hash % (2 * SENSOR_TYPES_MAX); i < 2 * SENSOR_TYPES_MAX; i++, slot = (slot + 1) % (2 * SENSOR_TYPES_MAX))
+    {
+        if (registry[slot].Constructor == nullptr)
         {
-            continue;
+            return nullptr;
         }
-        id = sensorStr.substr(0, sensorStr.find(':'));
-        type = sensorStr.substr(sensorStr.find(':') + 1);
-        sensor = createSensorByType(type, id);
-        if (sensor != nullptr)
+        if (registry[slot].Hash == hash && registry[slot].Tag == tag)
         {
-            memory.push_back(sensor);
-            logMessage("\t(*)Detected known sensor type:%s, sensor with ID:%s added!\n", sensor->Type.c_str(), sensor->UID.c_str());
+            return &registry[slot];
         }
     }
+    return nullptr;
+}
+
+SensorConstructor findSensorType(std::string_view tag)
+{
+    const SensorTypeEntry* entry = findEntry(tag);
+    return (entry != nullptr) ? entry->Constructor : nullptr;
+}
+
+SensorBulkConstructor findSensorBulkType(std::string_view tag)
+{
+    const SensorTypeEntry* entry = findEntry(tag);
+    return (entry != nullptr) ? entry->Bulk : nullptr;
+}
+
+BaseSensor* createSensorByType(std::string_view type, std::string_view uid, MemoryArena *arena)
+{
+    //Resolve type via sensor type registry (see REGISTER_SENSOR_TYPE)
+    SensorConstructor constructor = findSensorType(type);
+    if (constructor == nullptr)
+    {
+        return nullptr;
+    }
+
+    return constructor(std::string(uid), arena);
 }
 
-BaseSensor* createSensorByType(std::string type, std::string uid)
+/**
+ * @brief Entry of parsed sensor list.
+ */
+struct SensorListEntry
 {
-    //For ADC
-    if (type == "ADC")
+    std::string_view UID;         ///< Sensor UID.
+    std::string_view Tag;         ///< Type tag.
+    const SensorTypeEntry* Type;  ///< Registered type, nullptr for unknown type.
+};
+
+void createSensorList(std::vector<BaseSensor*> &memory, std::string_view stringSource, MemoryArena *arena)
+{
+    memory.clear();
+    //Expected format: ?0:ADC&1:ADC&2:TH
+    size_t count = (size_t)std::count(stringSource.begin(), stringSource.end(), ':');
+    std::vector<SensorListEntry> entries;
+    entries.reserve(count);
+
+    //Pass 1: parse list and resolve types (consecutive sensors of the same type share lookup)
+    KeyValueTokenizer tokenizer(stringSource, '&', ':');
+    KeyValuePair pair;
+    SensorListEntry entry = {};
+    while (tokenizer.next(pair))
     {
-        return createSensor<ADC>(uid);
+        if (entries.empty() || pair.Value != entry.Tag)
+        {
+            entry.Tag = pair.Value;
+            entry.Type = findEntry(pair.Value);
+        }
+        entry.UID = pair.Key;
+        entries.push_back(entry);
     }
-    //For TH
-    else if (type == "TH")
+
+    //Pass 2: construct sensors type by type, so sensors of one type are one contiguous block, list order is kept
+    memory.assign(entries.size(), nullptr);
+    std::vector<std::string_view> uids;
+    std::vector<BaseSensor*> block;
+    uids.reserve(entries.size());
+    block.reserve(entries.size());
+    size_t types = 0;
+    try
     {
-        return createSensor<TH>(uid);
+        for (size_t first = 0; first < entries.size(); first++)
+        {
+            if (entries[first].Type == nullptr || memory[first] != nullptr)
+            {
+                continue; // Unknown type or already created block
+            }
+
+            const SensorTypeEntry* type = entries[first].Type;
+            types++;
+            if (type->Bulk == nullptr)
+            {
+                //Type without bulk constructor is created one by one
+                for (size_t i = first; i < entries.size(); i++)
+                {
+                    if (entries[i].Type == type)
+                    {
+                        memory[i] = type->Constructor(std::string(entries[i].UID), arena);
+                    }
+                }
+                continue;
+            }
+
+            uids.clear();
+            for (size_t i = first; i < entries.size(); i++)
+            {
+                if (entries[i].Type == type)
+                {
+                    uids.push_back(entries[i].UID);
+                }
+            }
+            block.resize(uids.size());
+            type->Bulk(uids.data(), uids.size(), block.data(), arena);
+            for (size_t i = first, created = 0; created < block.size(); i++)
+            {
+                if (entries[i].Type == type)
+                {
+                    memory[i] = block[created++];
+                }
+            }
+        }
     }
-    else
+    catch (...)
     {
-        return nullptr;
+        //Keep created sensors in list (released by owner, e.g. SensorManager::erase())
+        memory.erase(std::remove(memory.begin(), memory.end(), nullptr), memory.end());
+        throw;
     }
-}
\ No newline at end of file
+    memory.erase(std::remove(memory.begin(), memory.end(), nullptr), memory.end());
+
+    LOG_INFO("\t(i)Found %d sensors, %d created in %d type blocks.\n", (int)entries.size(), (int)memory.size(), (int)types);
+}
@@ -20,9 +20,10 @@
  * 
  * @param type The sensor type.
  * @param uid The unique sensor identifier.
+ * @param arena The arena for sensor (optional), see createSensor().
  * @return The sensor object.
  */
-BaseSensor* createSensorByType(std::string type, std::string uid);
+BaseSensor* createSensorByType(std::string_view type, std::string_view uid, MemoryArena *arena = nullptr);
 
 /**
  * @brief Create a list of sensors.
@@ -30,17 +31,22 @@ BaseSensor* createSensorByType(std::string type, std::string uid);
  * This function creates a fixed list of sensors.
  * 
  * @param memory The list of sensors.
+ * @param arena The arena for sensors (optional), see createSensor().
  */
-void createSensorList(std::vector<BaseSensor*> &memory);
+void createSensorList(std::vector<BaseSensor*> &memory, MemoryArena *arena = nullptr);
 
 /**
  * @brief Create a list of sensors.
  * 
- * This function creates a list of sensors based on the given string source.
+ * This function creates a list of sensors based on the given string source (e.g. "0:ADC&1:ADC&2:TH").
+ * Storage is reserved by pre-counted entries, sensors of the same type are built by bulk constructor
+ * into arena (as many as fit) and one heap block for the rest (see createSensors()), order of the list is kept and one summary line is logged.
+ * Sensors of unknown types are skipped.
  * 
  * @param memory The list of sensors.
  * @param stringSource The string source.
+ * @param arena The arena for sensors (optional), see createSensor().
  */
-void createSensorList(std::vector<BaseSensor*> &memory, std::string stringSource);
+void createSensorList(std::vector<BaseSensor*> &memory, std::string_view stringSource, MemoryArena *arena = nullptr);
 
 #endif // SENSOR_FACTORY_HPP
\ No newline at end of file
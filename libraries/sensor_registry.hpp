@@ -0,0 +1,101 @@
+/**
+ * @file sensor_registry.hpp
+ * @brief Declares the sensor type registry, mapping type tags to sensor constructors.
+ *
+ * Sensor classes register themselves by REGISTER_SENSOR_TYPE(T) (T::TypeTag is the type tag),
+ * the factory then resolves type tag in O(1) via hashed table, without touching the factory.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ *
+ */
+
+#ifndef SENSOR_REGISTRY_HPP
+#define SENSOR_REGISTRY_HPP
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SENSOR_TYPES_MAX 16 ///< Maximal number of registered sensor types.
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+class BaseSensor;
+class MemoryArena;
+
+/**
+ * @brief Constructor of registered sensor type, sensor is placed into arena (if given and not full).
+ */
+typedef BaseSensor* (*SensorConstructor)(const std::string &uid, MemoryArena *arena);
+
+/**
+ * @brief Bulk constructor of registered sensor type, sensors are placed into one contiguous arena block.
+ */
+typedef size_t (*SensorBulkConstructor)(const std::string_view *uids, size_t count, BaseSensor **sensors, MemoryArena *arena);
+
+/*********************
+ *      DECLARES
+ *********************/
+
+/**
+ * @brief Compute hash of sensor type tag (FNV-1a).
+ *
+ * @param tag The type tag.
+ * @return The hash.
+ */
+constexpr uint32_t hashTypeTag(std::string_view tag)
+{
+    uint32_t hash = 2166136261u;
+    for (char c : tag)
+    {
+        hash = (hash ^ (uint8_t)c) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Register sensor type.
+ *
+ * @param tag The type tag, must have static storage (e.g. string literal).
+ * @param constructor The constructor of sensor type.
+ * @param bulk The bulk constructor of sensor type (optional).
+ * @return true if type was registered, false if registry is full or tag is already registered.
+ */
+bool registerSensorType(std::string_view tag, SensorConstructor constructor, SensorBulkConstructor bulk = nullptr);
+
+/**
+ * @brief Find constructor of registered sensor type.
+ *
+ * @param tag The type tag.
+ * @return The constructor or nullptr if type is unknown.
+ */
+SensorConstructor findSensorType(std::string_view tag);
+
+/**
+ * @brief Find bulk constructor of registered sensor type.
+ *
+ * @param tag The type tag.
+ * @return The bulk constructor or nullptr if type is unknown or has no bulk constructor.
+ */
+SensorBulkConstructor findSensorBulkType(std::string_view tag);
+
+/**
+ * @brief Register sensor class T (with static TypeTag) into the sensor type registry.
+ * 
+ * Sensors are constructed by createSensor<T> and createSensors<T>, so it has to be used after their definition.
+ */
+#define REGISTER_SENSOR_TYPE(T) \
+    inline const bool T##_TypeRegistered = registerSensorType(T::TypeTag, \
+        [](const std::string &uid, MemoryArena *arena) -> BaseSensor* { return createSensor<T>(uid, arena); }, \
+        [](const std::string_view *uids, size_t count, BaseSensor **sensors, MemoryArena *arena) -> size_t { \
+            return createSensors<T>(uids, count, sensors, arena); });
+
+#endif // SENSOR_REGISTRY_HPP
@@ -30,8 +30,8 @@ void configSensor(BaseSensor *sensor, const std::string &config) {
     try {
         sensor->config(config);
     } catch (const Exception &ex) {
-        ex.print();
-        sensor->setError(new Exception(ex));
+        LOG_EXCEPTION(ex);
+        sensor->setError(ex);
     }
 }
 
@@ -44,21 +44,64 @@ void updateSensor(BaseSensor *sensor, const std::string &update) {
     try {
         sensor->update(update);
     } catch (const Exception &ex) {
-        ex.print();
-        sensor->setError(new Exception(ex));
+        LOG_EXCEPTION(ex);
+        sensor->setError(ex);
     }
 }
 
+bool applySensor(BaseSensor *sensor, const SensorMetadata &metadata) {
+    if(sensor == nullptr) {
+        return false;
+    }
+
+    try {
+        return sensor->applyValues(metadata);
+    } catch (const Exception &ex) {
+        LOG_EXCEPTION(ex);
+        sensor->setError(ex);
+    }
+    return false;
+}
+
+bool applySensor(BaseSensor *sensor, const SensorRecord &record) {
+    if(sensor == nullptr) {
+        return false;
+    }
+
+    try {
+        return sensor->applyValues(record);
+    } catch (const Exception &ex) {
+        LOG_EXCEPTION(ex);
+        sensor->setError(ex);
+    }
+    return false;
+}
+
+bool applySensor(BaseSensor *sensor, const BinaryFrame &frame) {
+    if(sensor == nullptr) {
+        return false;
+    }
+
+    try {
+        return sensor->applyValues(frame);
+    } catch (const Exception &ex) {
+        LOG_EXCEPTION(ex);
+        sensor->setError(ex);
+    }
+    return false;
+}
+
 void printSensor(BaseSensor *sensor) {
     if(sensor == nullptr) {
         return;
     }
     
+    METRIC_SCOPE(PRINT);
     try {
         sensor->print();
     } catch (const Exception &ex) {
-        ex.print();
-        sensor->setError(new Exception(ex));
+        LOG_EXCEPTION(ex);
+        sensor->setError(ex);
     }
 }
 
@@ -70,8 +113,21 @@ void syncSensor(BaseSensor *sensor) {
     try {
         sensor->synchronize();
     } catch (const Exception &ex) {
-        ex.print();
-        sensor->setError(new Exception(ex));
+        LOG_EXCEPTION(ex);
+        sensor->setError(ex);
+    }
+}
+
+void reconfigureSensor(BaseSensor *sensor) {
+    if(sensor == nullptr) {
+        return;
+    }
+
+    try {
+        sensor->reconfigure();
+    } catch (const Exception &ex) {
+        LOG_EXCEPTION(ex);
+        sensor->setError(ex);
     }
 }
 
@@ -83,8 +139,8 @@ void drawSensor(BaseSensor *sensor) {
     try {
         sensor->draw();
     } catch (const Exception &ex) {
-        ex.print();
-        sensor->setError(new Exception(ex));
+        LOG_EXCEPTION(ex);
+        sensor->setError(ex);
     }
 }
 
@@ -94,9 +150,9 @@ void constructSensor(BaseSensor *sensor) {
     }
 
     try {
-        sensor->construct();
+        sensor->ensureConstructed();
     } catch (const Exception &ex) {
-        ex.print();
-        sensor->setError(new Exception(ex));
+        LOG_EXCEPTION(ex);
+        sensor->setError(ex);
     }
 }
@@ -22,10 +22,20 @@
 #include "helpers.hpp"     ///< Helper functions.
 #include "parser.hpp"      ///< Parser functions.
 #include "messenger.hpp"   ///< Messenger functions.
-
+#include "protocol.hpp"    ///< Binary protocol.
+#include "sensor_registry.hpp" ///< Sensor type registry.
+#include "metrics.hpp"     ///< Runtime metrics.
+#include "recorder.hpp"    ///< Readings recorder.
+#include "alarms.hpp"      ///< Alarm rules.
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <new>
 #include <string>
-#include <unordered_map>
-#include <map>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 /**
  * @enum SensorStatus
@@ -75,296 +85,1726 @@ enum class DataType {
 };
 
 /**
- * @struct SensorParam
- * @brief Structure for sensor parameters.
+ * @brief Size of text buffer needed to format any numerical parameter value.
+ */
+#define SENSOR_PARAM_TEXT_SIZE 32
+
+/**
+ * @struct SensorError
+ * @brief Inline error slot of sensor, stores copy of exception without allocation.
+ */
+struct SensorError
+{
+    bool Active = false;                          ///< Error is set.
+    ErrorCode Code = ErrorCode::NOT_DEFINED_ERROR; ///< Error code.
+    char Message[SENSOR_ERROR_MESSAGE_SIZE] = {}; ///< Error message (truncated).
+    char Source[SENSOR_ERROR_SOURCE_SIZE] = {};   ///< Error source (truncated).
+};
+
+/**
+ * @struct SensorSnapshot
+ * @brief Immutable copy of sensor state, published by communication task for readers on other cores/threads.
  * 
- * This structure can be used to store sensor parameters for configuration and updating.
+ * Values are in schema slot order, STRING values are not included (NaN).
  */
-struct SensorParam
+struct SensorSnapshot
 {
-    std::string Value;  ///< Parameter value.
-    std::string Unit;   ///< Parameter unit.
-    DataType DataType; ///< Parameter data type.
+    SensorStatus Status;                    ///< Sensor status.
+    bool Error;                             ///< Sensor has error.
+    uint8_t ValuesCount;                    ///< Number of values.
+    unsigned long Time;                     ///< Time of publication in milliseconds.
+    double Values[SENSOR_SNAPSHOT_VALUES];  ///< Numerical values.
 };
 
 /**
- * @class BaseSensor
- * @brief Abstract base class for sensors.
+ * @struct SensorStats
+ * @brief Runtime metrics of sensor (recorded only with METRICS), written by communication task.
+ */
+struct SensorStats
+{
+    uint32_t Updates = 0;    ///< Number of applied updates.
+    uint32_t Errors = 0;     ///< Number of updates with invalid value.
+    uint32_t UpdateTime = 0; ///< Duration of last update in microseconds.
+    uint32_t Latency = 0;    ///< Last request round trip in milliseconds.
+    uint32_t MaxLatency = 0; ///< Longest request round trip in milliseconds.
+};
+
+/**
+ * @struct ParamSchema
+ * @brief Static description of sensor parameter, shared by all sensors of the type.
+ */
+struct ParamSchema
+{
+    const char* Key;      ///< Parameter key.
+    const char* Unit;     ///< Parameter unit.
+    ::DataType DataType;  ///< Parameter data type.
+    const char* Default;  ///< Default value as text.
+    uint32_t KeyHash = hashKey(Key); ///< Case-folded hash of key, precomputed for matching of received keys.
+};
+
+/**
+ * @struct SensorSchema
+ * @brief Static description of sensor type (flyweight), shared by all sensors of the type.
  * 
- * Defines common properties and virtual methods for sensor initialization, configuration,
- * updating, and printing. It also provides a helper method, printBasicInfo(), that prints
- * common sensor details.
+ * Parameter index in schema is parameter slot (index of value in sensor and binary protocol).
  */
-class BaseSensor {
-protected:
-    bool redrawPenging = true;    ///< Flag to indicate if sensor needs to be redrawn.
-    bool isConfigsSync = false;          ///< Flag to indicate if sensor congig is synchronized with real sensor.
-    bool isValuesSync = false;          ///< Flag to indicate if sensor values is synchronized with real sensor.
+struct SensorSchema
+{
+    const char* Type;               ///< Sensor type as text.
+    const char* Description;        ///< Description of the sensor.
+    const ParamSchema* Configs;     ///< Configuration parameters.
+    size_t ConfigsCount;            ///< Number of configuration parameters.
+    const ParamSchema* Values;      ///< Value parameters.
+    size_t ValuesCount;             ///< Number of value parameters.
+};
 
-    std::unordered_map<std::string, SensorParam> Values; ///< Sensor values.
-    std::map<std::string, SensorParam> Configs;          ///< Sensor configurations.
+/**
+ * @brief History of numerical value parameter.
+ */
+typedef SampleHistory<SENSOR_HISTORY_SIZE> ValueHistory;
 
-    void syncConfigs() {
-        std::string configRequest = "?CONFIG&id=" + UID;
-        for (auto &c : Configs) {
-            configRequest += "&" + c.first + "=" + c.second.Value;
-        }
-        sendMessage(configRequest);
+/**
+ * @struct SensorBlock
+ * @brief Heap block of sensors created by createSensors() (block does not fit into arena).
+ * 
+ * Sensors are placed behind the header, block is released by destroySensor() of its last sensor.
+ */
+struct SensorBlock
+{
+    size_t Live = 0; ///< Number of live sensors in the block.
 
-        isConfigsSync = true; // Set flag to indicate sensor is synchronized with real sensor.
-    }
+    /// Size of header, sensors behind it keep alignment of heap allocation.
+    static constexpr size_t HeaderSize = (sizeof(size_t) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
 
-    void syncValues()
+    /**
+     * @brief Allocate block for count objects of given size.
+     */
+    static SensorBlock* allocate(size_t size, size_t count)
     {
-        isValuesSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
-        std::string updateRequest = "?UPDATE&id=" + UID;
-        std::string updateResponse = "";
-
-        //Check if response is valid
-        SensorMetadata metadata;
-        //Start update sync process
-        sendMessage(updateRequest);
-        updateResponse = receiveMessage();
-        metadata = ParseMetadata(updateResponse);
+        return new (::operator new(HeaderSize + size * count)) SensorBlock();
+    }
 
-        if( IsValid(&metadata, UID) )
-        {
-            update(metadata.Data);
-            setStatus(metadata.Status);
+    /**
+     * @brief Release block, all its sensors must be already destroyed.
+     */
+    static void release(SensorBlock *block)
+    {
+        block->~SensorBlock();
+        ::operator delete(block);
+    }
 
-            redrawPenging = true; // Set flag to redraw sensor - values updated.
-            isValuesSync = true; // Set flag to indicate sensor is synchronized with real sensor.  
-        }      
+    /**
+     * @brief Get storage of object with given index.
+     */
+    void* at(size_t size, size_t index)
+    {
+        return (unsigned char*)this + HeaderSize + size * index;
     }
+};
 
-public:
-    std::string UID;                ///< Unique sensor identifier.
-    SensorStatus Status;             ///< Sensor status.
-    std::string Type;       ///< Sensor type as text.
-    std::string Description;///< Description of the sensor.
-    Exception *Error;       ///< Pointer to an exception object (if any).
+/**
+ * @struct SensorParam
+ * @brief Structure for sensor parameters.
+ * 
+ * This structure can be used to store sensor parameters for configuration and updating.
+ * INT/FLOAT/DOUBLE values are stored natively (converted once on assign), only STRING
+ * values are stored as text. Key, unit and data type are shared via parameter schema.
+ */
+struct SensorParam
+{
+    const ParamSchema* Schema; ///< Shared parameter description.
+    union
+    {
+        int Int;        ///< Value of INT parameter.
+        float Float;    ///< Value of FLOAT parameter.
+        double Double;  ///< Value of DOUBLE parameter.
+    } Number;           ///< Native numerical value.
+    std::string Text;   ///< Value of STRING parameter.
+    bool Dirty = false;  ///< Value changed since last clear (e.g. since last draw).
+    std::unique_ptr<ValueHistory> History; ///< Optional sample history (numerical values only).
 
-    //lv_obj_t *ui_Container; ///< Pointer to the UI widgets container.
     /**
-     * @brief Equality operator for comparing sensors by UID.
+     * @brief Constructs a new SensorParam object with default value.
      * 
-     * @param sensor The sensor to compare with.
-     * @return true if the sensors have the same UID, false otherwise.
+     * @param schema The parameter description, must outlive the parameter.
+     * @throws InvalidDataTypeException if default value does not match data type.
      */
-    bool operator==(const BaseSensor &sensor) const {
-        return UID == sensor.UID;
+    SensorParam(const ParamSchema &schema) : Schema(&schema)
+    {
+        Number.Double = 0;
+        if(!assign(schema.Default))
+        {
+            throw InvalidDataTypeException("SensorParam::SensorParam", std::string(schema.Default) + " is not valid default value!");
+        }
+        Dirty = false;
     }
 
     /**
-     * @brief Equality operator for comparing sensors by UID.
-     * 
-     * @param uid The UID to compare with.
-     * @return true if the sensor's UID matches the given UID, false otherwise.
+     * @brief Get parameter key.
      */
-    bool operator==(const std::string uid) const {
-        return UID == uid;
+    const char* key() const
+    {
+        return Schema->Key;
     }
 
     /**
-     * @brief Constructs a new BaseSensor object.
-     * 
-     * @param uid The unique sensor identifier.
+     * @brief Get case-folded hash of parameter key (see hashKey()).
      */
-    BaseSensor(std::string uid) : UID(uid), Status(SensorStatus::OK) 
+    uint32_t keyHash() const
     {
-        Error = nullptr;
+        return Schema->KeyHash;
+    }
 
-        redrawPenging = true;
-        isConfigsSync = false;
-        isValuesSync = false;
+    /**
+     * @brief Get parameter unit.
+     */
+    const char* unit() const
+    {
+        return Schema->Unit;
     }
 
     /**
-     * @brief Virtual destructor.
+     * @brief Get parameter data type.
      */
-    virtual ~BaseSensor() 
+    ::DataType type() const
     {
-        delete Error;
+        return Schema->DataType;
     }
 
     /**
-     * @brief Set sensor status.
+     * @brief Assign value from text, conversion is done once here.
      * 
-     * This function sets the sensor status based on the given status string.
+     * Dirty flag is set if value changed.
      * 
-     * @param status The status string.
+     * @param value The value as text.
+     * @return true if value was assigned, false if text does not match data type (value is kept).
      */
-    void setStatus(std::string status)
+    bool assign(std::string_view value)
     {
-        if( status.empty() )
+        switch (type())
         {
-            return;
-        }
-
-        if(status == "1")
+        case ::DataType::INT:
         {
-            Status = SensorStatus::OK;
+            int number;
+            return parseNumber(value, number) && assignNumber(number);
         }
-        else if(status == "-1")
+        case ::DataType::FLOAT:
         {
-            Status = SensorStatus::ERROR;
+            float number;
+            return parseNumber(value, number) && assignNumber(number);
         }
-        else if(status == "0")
+        case ::DataType::DOUBLE:
         {
-            Status = SensorStatus::OFFLINE;
+            double number;
+            return parseNumber(value, number) && assignNumber(number);
+        }
+        default:
+            if(Text != value)
+            {
+                Text.assign(value.data(), value.size());
+                Dirty = true;
+            }
+            return true;
         }
     }
 
     /**
-     * @brief Get value from configuration.
+     * @brief Get value converted to type T.
      * 
-     * This function retrieves the value of a configuration parameter by key.
+     * Numerical values are only casted, no parsing is done.
      * 
-     * @param key The key of the configuration parameter.
-     * @return The value of the configuration parameter.
+     * @return The value as type T.
      */
     template <typename T>
-    T getConfig(const std::string &key) {
-        std::string value;
-        if (Configs.find(key) != Configs.end()) {
-            value = Configs[key].Value;
+    T as() const
+    {
+        if constexpr (std::is_same<T, std::string>::value)
+        {
+            return toString();
         }
-        if(value.empty()) {
-            throw ConfigurationNotFoundException("BaseSensor::getConfig", "Configuration not found for key: " + key);
+        else
+        {
+            static_assert(std::is_arithmetic<T>::value, "T must be arithmetic or std::string");
+            switch (type())
+            {
+            case ::DataType::INT:
+                return static_cast<T>(Number.Int);
+            case ::DataType::FLOAT:
+                return static_cast<T>(Number.Float);
+            case ::DataType::DOUBLE:
+                return static_cast<T>(Number.Double);
+            default:
+                return convertStringToType<T>(Text);
+            }
         }
-        
-        try
+    }
+
+    /**
+     * @brief Get value converted to type T, without throwing.
+     * 
+     * @param value The output value, untouched on failure.
+     * @return true if value was converted, false if STRING value is not a number of type T.
+     */
+    template <typename T>
+    bool tryAs(T &value) const
+    {
+        if constexpr (std::is_same<T, std::string>::value)
         {
-            return convertStringToType<T>(value);
+            value = toString();
+            return true;
         }
-        catch(const std::exception& e)
+        else
         {
-            throw InvalidDataTypeException("BaseSensor::getConfig", e.what());
-        }       
+            static_assert(std::is_arithmetic<T>::value, "T must be arithmetic or std::string");
+            if(type() != ::DataType::STRING)
+            {
+                value = as<T>();
+                return true;
+            }
+
+            typename std::conditional<std::is_integral<T>::value, int, double>::type number;
+            if(!parseNumber(Text, number))
+            {
+                return false;
+            }
+            value = static_cast<T>(number);
+            return true;
+        }
     }
 
     /**
-     * @brief Set configuration value.
+     * @brief Assign numerical value, converted to parameter data type.
      * 
-     * This function sets the value of a configuration parameter by key.
+     * Dirty flag is set if value changed.
      * 
-     * @param key The key of the configuration parameter.
-     * @param value The value to set.
+     * @param value The value.
+     * @return true if value was assigned, false for STRING parameter.
      */
-    void setConfig(const std::string &key, const std::string &value) {
-        if (Configs.find(key) != Configs.end()) {
-            Configs[key].Value = value;
-        }
-        else{
-            throw ConfigurationNotFoundException("BaseSensor::setConfig", "Configuration not found for key: " + key);
+    template <typename T>
+    bool assignNumber(T value)
+    {
+        switch (type())
+        {
+        case ::DataType::INT:
+            return store(Number.Int, static_cast<int>(value));
+        case ::DataType::FLOAT:
+            return store(Number.Float, static_cast<float>(value));
+        case ::DataType::DOUBLE:
+            return store(Number.Double, static_cast<double>(value));
+        default:
+            return false;
         }
+    }
 
-        isConfigsSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
+    /**
+     * @brief Store value into field and set dirty flag if it changed.
+     */
+    template <typename T>
+    bool store(T &field, T value)
+    {
+        if(field != value)
+        {
+            field = value;
+            Dirty = true;
+        }
+        return true;
     }
 
     /**
-     * @brief Get value from sensor.
+     * @brief Assign value decoded from binary frame.
      * 
-     * This function retrieves the value of a sensor parameter by key.
+     * @param param The decoded parameter.
+     * @return true if value was assigned, false otherwise.
+     */
+    bool assign(const BinaryParam &param)
+    {
+        switch (param.Type)
+        {
+        case ProtocolType::INT:
+            return assignNumber(param.Number.Int);
+        case ProtocolType::FLOAT:
+            return assignNumber(param.Number.Float);
+        case ProtocolType::DOUBLE:
+            return assignNumber(param.Number.Double);
+        default:
+            return assign(param.Text);
+        }
+    }
+
+    /**
+     * @brief Record current value into history (if enabled).
      * 
-     * @param key The key of the sensor parameter.
-     * @return The value of the sensor parameter.
+     * @param time The sample timestamp in milliseconds.
      */
-    template <typename T>
-    T getValue(const std::string &key) {
-        std::string value;
-        if (Values.find(key) != Values.end()) {
-            value = Values[key].Value;
+    void record(unsigned long time)
+    {
+        if(History && type() != ::DataType::STRING)
+        {
+            History->push(time, as<float>());
         }
-        if(value.empty()) {
-            throw ValueNotFoundException("BaseSensor::getValue", "Value not found for key: " + key);
+    }
+
+    /**
+     * @brief Encode value into binary frame.
+     * 
+     * @param writer The frame writer.
+     * @param slot The parameter index.
+     * @return true if value fits into frame, false otherwise.
+     */
+    bool encode(BinaryFrameWriter &writer, uint8_t slot) const
+    {
+        switch (type())
+        {
+        case ::DataType::INT:
+            return writer.addInt(slot, Number.Int);
+        case ::DataType::FLOAT:
+            return writer.addFloat(slot, Number.Float);
+        case ::DataType::DOUBLE:
+            return writer.addDouble(slot, Number.Double);
+        default:
+            return writer.addText(slot, Text);
         }
-        
-        try
+    }
+
+    /**
+     * @brief Check if parameter holds value.
+     * 
+     * @return true for numerical parameters and non-empty STRING parameters.
+     */
+    bool hasValue() const
+    {
+        return type() != ::DataType::STRING || !Text.empty();
+    }
+
+    /**
+     * @brief Format value as text for printing.
+     * 
+     * @param buffer The buffer for numerical values (SENSOR_PARAM_TEXT_SIZE is enough).
+     * @param size The buffer size.
+     * @return The view of formatted value, valid while buffer (or parameter for STRING) lives.
+     */
+    std::string_view format(char *buffer, size_t size) const
+    {
+        int len = 0;
+        switch (type())
         {
-            return convertStringToType<T>(value);
+        case ::DataType::INT:
+            len = snprintf(buffer, size, "%d", Number.Int);
+            break;
+        case ::DataType::FLOAT:
+            len = snprintf(buffer, size, "%.7g", Number.Float);
+            break;
+        case ::DataType::DOUBLE:
+            len = snprintf(buffer, size, "%.15g", Number.Double);
+            break;
+        default:
+            return Text;
         }
-        catch(const std::exception& e)
+
+        if(len < 0)
         {
-            throw InvalidDataTypeException("BaseSensor::getValue", e.what());
-        } 
+            return std::string_view();
+        }
+        return std::string_view(buffer, ((size_t)len < size) ? (size_t)len : size - 1);
     }
 
     /**
-     * @brief Set sensor value.
+     * @brief Get value as text.
      * 
-     * This function sets the value of a sensor parameter by key.
+     * @return The value as string.
+     */
+    std::string toString() const
+    {
+        char buffer[SENSOR_PARAM_TEXT_SIZE];
+        return std::string(format(buffer, sizeof(buffer)));
+    }
+};
+
+/**
+ * @class BaseSensor
+ * @brief Abstract base class for sensors.
+ * 
+ * Defines common properties and virtual methods for sensor initialization, configuration,
+ * updating, and printing. It also provides a helper method, printBasicInfo(), that prints
+ * common sensor details.
+ */
+class BaseSensor {
+protected:
+    bool redrawPenging = true;    ///< Flag to indicate if sensor needs to be redrawn.
+    uint32_t Changes = 0;         ///< Number of changes (values, extra values, status) applied by updates.
+    uint32_t ConfigsPending = 0;        ///< Bit mask of configs (by slot) not synchronized with real sensor.
+    bool isConstructed = false;         ///< Flag to indicate if UI widgets are constructed.
+    bool isVisible = true;              ///< Flag to indicate if sensor is visible on screen (UI is constructed lazily).
+    bool isValuesSync = false;          ///< Flag to indicate if sensor values is synchronized with real sensor.
+    unsigned long UpdatedAt = 0;        ///< Time of last applied update in milliseconds.
+    unsigned long FreshTTL = SENSOR_FRESH_TTL; ///< Time for which synchronized values are fresh in milliseconds.
+    AlarmTable Alarms;                  ///< Compiled alarm rules of values.
+    RttEstimator RoundTrip;             ///< Measured round trip of update requests of the sensor.
+    uint8_t Failures = 0;               ///< Consecutive failed update requests.
+    uint8_t ProbeBackoff = 0;           ///< Backoff exponent of probes while circuit is open.
+    bool CircuitOpen = false;           ///< Sensor is OFFLINE after SENSOR_MAX_FAILURES, only probes are sent.
+    unsigned long ProbeAt = 0;          ///< Time of next probe while circuit is open.
+    AlarmCallback OnAlarm = nullptr;    ///< Callback of alarm changes.
+    void *AlarmContext = nullptr;       ///< Context of alarm callback.
+
+    const SensorSchema* Schema = nullptr; ///< Shared sensor type description.
+    std::vector<SensorParam> Values;      ///< Sensor values, indexed by schema slot.
+    std::vector<SensorParam> Configs;     ///< Sensor configurations, indexed by schema slot.
+    Seqlock<SensorSnapshot> Snapshot;     ///< Published state for lock-free readers.
+    Messenger* Link = nullptr;            ///< Link to the real sensor, nullptr for default messenger.
+    SensorStats Stats;                    ///< Runtime metrics.
+
+    /**
+     * @brief Record applied update into sensor and global metrics.
      * 
-     * @param key The key of the sensor parameter.
-     * @param value The value to set.
+     * @param start The start of update in microseconds (see getMicros()).
+     * @param valid Flag if all values were valid.
      */
-    void setValue(const std::string &key, const std::string &value) {
-        if (Values.find(key) != Values.end()) {
-            Values[key].Value = value;
+    void recordUpdate(unsigned long start, bool valid)
+    {
+        uint32_t micros = (uint32_t)(getMicros() - start);
+        getMetrics().record(MetricTimer::UPDATE, micros);
+        Stats.Updates++;
+        Stats.UpdateTime = micros;
+        if(!valid)
+        {
+            Stats.Errors++;
+            getMetrics().count(MetricCounter::INVALID_VALUES);
         }
-        else{
-            throw ValueNotFoundException("BaseSensor::setValue", "Value not found for key: " + key);
+    }
+
+    #ifdef RECORDER
+        /**
+         * @brief Record committed value into readings recorder (STRING values are not recorded).
+         * 
+         * @param slot The value slot.
+         * @param param The value parameter.
+         * @param time The time of update in milliseconds.
+         */
+        void recordReading(size_t slot, const SensorParam &param, unsigned long time) const
+        {
+            ReadingRecorder &recorder = getRecorder();
+            if(!recorder.isActive() || param.type() == ::DataType::STRING)
+            {
+                return;
+            }
+            ReadingRecord reading;
+            reading.Time = (uint32_t)time;
+            reading.Sensor = (ID >= 0) ? (uint16_t)ID : readingSensorHandle(UID); // Interned ID is the same number
+            reading.Slot = (uint8_t)slot;
+            reading.Value.Double = 0;
+            switch (param.type())
+            {
+            case ::DataType::INT:
+                reading.Type = (uint8_t)ProtocolType::INT;
+                reading.Value.Int = param.Number.Int;
+                break;
+            case ::DataType::FLOAT:
+                reading.Type = (uint8_t)ProtocolType::FLOAT;
+                reading.Value.Float = param.Number.Float;
+                break;
+            default:
+                reading.Type = (uint8_t)ProtocolType::DOUBLE;
+                reading.Value.Double = param.Number.Double;
+                break;
+            }
+            recorder.record(reading);
+        }
+    #endif
+
+    /**
+     * @brief Evaluate alarm rules of assigned value (only slots watched by some rule).
+     * 
+     * @param slot The value slot.
+     * @param param The value parameter.
+     * @param time The time of update in milliseconds.
+     */
+    void evaluateAlarms(size_t slot, const SensorParam &param, unsigned long time)
+    {
+        if(!Alarms.watches(slot) || param.type() == ::DataType::STRING)
+        {
+            return;
         }
+        Alarms.update(slot, param.as<double>(), time, [this](const AlarmRule &rule, double value) {
+            LOG_INFO("Alarm of sensor %s %s (%s = %g)\n", UID.c_str(), rule.Active ? "raised" : "cleared", Values[rule.Slot].key(), value);
+            if(rule.SetStatus)
+            {
+                applyAlarmStatus();
+            }
+            if(OnAlarm != nullptr)
+            {
+                OnAlarm(*this, rule, value, AlarmContext);
+            }
+        });
     }
 
     /**
-     * @brief Get units of sensor value parameter.
+     * @brief Keep status ERROR while some alarm setting status is active (status received from sensor is overridden).
+     */
+    void applyAlarmStatus()
+    {
+        if(Alarms.isStatusActive())
+        {
+            setStatus((int)SensorStatus::ERROR);
+        }
+    }
+
+    /**
+     * @brief Find parameter by case-insensitive key match without allocation.
      * 
-     * This function retrieves the units of a sensor value parameter by key.
+     * Sensors hold only a few parameters, so linear search compares precomputed key hashes,
+     * key text is compared only on hash match.
+     * 
+     * @param params The parameters (Configs or Values).
+     * @param key The key of the parameter.
+     * @param hash The case-folded hash of the key (see hashKey()).
+     * @return Pointer to the parameter or nullptr if not found.
+     */
+    template <typename Container>
+    static auto findParameter(Container &params, std::string_view key, uint32_t hash) -> decltype(&params[0]) {
+        for (auto &p : params) {
+            if (p.keyHash() == hash && equalsIgnoreCase(key, p.key())) {
+                return &p;
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename Container>
+    static auto findParameter(Container &params, std::string_view key) -> decltype(&params[0]) {
+        return findParameter(params, key, hashKey(key));
+    }
+
+    /**
+     * @brief Append configs selected by mask (by slot) as "id=UID&key=value..".
+     * 
+     * @param out The message, nothing is appended if configs do not fit into limit.
+     * @param limit The maximal message size.
+     * @param mask The bit mask of configs.
+     * @return true if configs were appended, false if they do not fit.
+     */
+    bool appendConfigs(std::string &out, size_t limit, uint32_t mask) const {
+        size_t mark = out.size();
+        char buffer[SENSOR_PARAM_TEXT_SIZE];
+        out.append("id=").append(UID);
+        for (size_t i = 0; i < Configs.size() && i < SENSOR_MAX_CONFIGS; i++) {
+            if(mask & ((uint32_t)1 << i)) {
+                std::string_view text = Configs[i].format(buffer, sizeof(buffer));
+                out.append("&").append(Configs[i].key()).append("=").append(text.data(), text.size());
+            }
+        }
+        if(out.size() > limit) {
+            out.resize(mark);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get parameter value converted to type T, single lookup and no throwing.
+     * 
+     * @param params The parameters (Configs or Values).
+     * @param key The key of the parameter.
+     * @param value The output value, untouched on failure.
+     * @return SUCCESS, VALUE_NOT_FOUND or INVALID_VALUE.
+     */
+    template <typename T>
+    static ErrorCode tryGetParameter(const std::vector<SensorParam> &params, std::string_view key, T &value) {
+        const SensorParam *param = findParameter(params, key);
+        if(param == nullptr || !param->hasValue()) {
+            return ErrorCode::VALUE_NOT_FOUND;
+        }
+        return param->tryAs(value) ? ErrorCode::SUCCESS : ErrorCode::INVALID_VALUE;
+    }
+
+    /**
+     * @brief Assign parameters from key=value&key=value string in single pass, without throwing.
+     * 
+     * Unknown keys and empty values are skipped, invalid values are kept and reported.
+     * 
+     * @param params The parameters (Configs or Values).
+     * @param source The key-value string.
+     * @return SUCCESS or INVALID_VALUE if some value does not match its data type.
+     */
+    ErrorCode assignParameters(std::vector<SensorParam> &params, std::string_view source) {
+        KeyValueTokenizer tokenizer(source, '&');
+        KeyValuePair pair;
+        bool valid = true;
+        unsigned long now = getMillis();
+        while (tokenizer.next(pair)) {
+            if(pair.Value.empty()) {
+                continue;
+            }
+            SensorParam *param = findParameter(params, pair.Key, pair.KeyHash);
+            if(param != nullptr) {
+                bool dirty = param->Dirty;
+                param->Dirty = false;
+                if(param->assign(pair.Value)) {
+                    param->record(now);
+                    if(&params == &Configs && param->Dirty) {
+                        onConfigChanged((size_t)(param - params.data()));
+                    }
+                    if(&params == &Values) {
+                        Changes += param->Dirty;
+                        evaluateAlarms((size_t)(param - params.data()), *param, now);
+                    }
+                    #ifdef RECORDER
+                        if(&params == &Values) {
+                            recordReading((size_t)(param - params.data()), *param, now);
+                        }
+                    #endif
+                } else {
+                    valid = false;
+                }
+                param->Dirty |= dirty;
+                redrawPenging |= param->Dirty; // Redraw only if value changed.
+            }
+            else if(&params == &Values) {
+                valid &= assignExtraValue(pair.Key, pair.Value) != ErrorCode::INVALID_VALUE;
+            }
+        }
+        return valid ? ErrorCode::SUCCESS : ErrorCode::INVALID_VALUE;
+    }
+
+    /**
+     * @brief Called when value of configuration changed (by setConfig(), config() or tryConfig()).
+     * 
+     * Sensors with state derived from configs (e.g. scaling) invalidate it here, no-op by default.
+     * 
+     * @param slot The config slot (index of config in sensor schema).
+     */
+    virtual void onConfigChanged(size_t slot) {
+        (void)slot;
+    }
+
+    /**
+     * @brief Assign value not declared in schema (e.g. channel array of multi-channel sensor).
+     * 
+     * Called by update for unknown keys, unknown keys are ignored by default.
+     * 
+     * @param key The key of the value.
+     * @param value The value as text.
+     * @return SUCCESS if assigned, VALUE_NOT_FOUND if key is unknown or INVALID_VALUE.
+     */
+    virtual ErrorCode assignExtraValue(std::string_view key, std::string_view value) {
+        (void)key;
+        (void)value;
+        return ErrorCode::VALUE_NOT_FOUND;
+    }
+
+    /**
+     * @brief Assign binary value with slot behind schema values (e.g. channel of multi-channel sensor).
+     * 
+     * @param slot The slot index relative to the end of schema values.
+     * @param param The decoded parameter.
+     * @return SUCCESS if assigned, VALUE_NOT_FOUND if slot is unknown or INVALID_VALUE.
+     */
+    virtual ErrorCode assignExtraValue(size_t slot, const BinaryParam &param) {
+        (void)slot;
+        (void)param;
+        return ErrorCode::VALUE_NOT_FOUND;
+    }
+
+    /**
+     * @brief Apply sensor type schema, parameters are created with default values.
+     * 
+     * @param schema The sensor type description, must have static lifetime.
+     * @throws InvalidDataTypeException if default value does not match data type.
+     */
+    void applySchema(const SensorSchema &schema) {
+        Schema = &schema;
+        Type = schema.Type;
+        Description = schema.Description;
+
+        Configs.clear();
+        Configs.reserve(schema.ConfigsCount);
+        for (size_t i = 0; i < schema.ConfigsCount; i++) {
+            Configs.emplace_back(schema.Configs[i]);
+        }
+
+        Values.clear();
+        Values.reserve(schema.ValuesCount);
+        for (size_t i = 0; i < schema.ValuesCount; i++) {
+            Values.emplace_back(schema.Values[i]);
+        }
+
+        if(schema.ConfigsCount > SENSOR_MAX_CONFIGS) {
+            throw InvalidDataTypeException("BaseSensor::applySchema", "Too many configuration parameters!");
+        }
+        ConfigsPending = (schema.ConfigsCount < SENSOR_MAX_CONFIGS) ? ((uint32_t)1 << schema.ConfigsCount) - 1 : ~(uint32_t)0; // All configs are not synchronized with real sensor.
+        isValuesSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
+    }
+
+    /**
+     * @brief Clear dirty flags of all parameters, called when sensor was drawn.
+     */
+    void clearDirty() {
+        for (auto &v : Values) {
+            v.Dirty = false;
+        }
+        for (auto &c : Configs) {
+            c.Dirty = false;
+        }
+        redrawPenging = false;
+    }
+
+    /**
+     * @brief Call function for every parameter changed since last draw, so draw updates only changed labels.
+     * 
+     * @param fn The function (bool config, size_t slot, const SensorParam &param).
+     */
+    template <typename F>
+    void forEachDirtyParameter(F &&fn) const {
+        for (size_t i = 0; i < Configs.size(); i++) {
+            if (Configs[i].Dirty) {
+                fn(true, i, Configs[i]);
+            }
+        }
+        for (size_t i = 0; i < Values.size(); i++) {
+            if (Values[i].Dirty) {
+                fn(false, i, Values[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Send not synchronized configs to the real sensor (only configs with pending bit).
+     * 
+     * @throws SensorSynchronizationFailException if configs do not fit into binary frame.
+     */
+    void syncConfigs() {
+        if(ConfigsPending == 0) {
+            return;
+        }
+
+        if(isBinaryProtocol() && WireID >= 0) {
+            BinaryFrameWriter writer(ProtocolCommand::CONFIG, (uint8_t)WireID);
+            for (size_t i = 0; i < Configs.size(); i++) {
+                if(ConfigsPending & ((uint32_t)1 << i)) {
+                    Configs[i].encode(writer, (uint8_t)i);
+                }
+            }
+            std::string_view frame = writer.finish();
+            if(frame.empty()) {
+                throw SensorSynchronizationFailException("BaseSensor::syncConfigs", "Configuration does not fit into binary frame!");
+            }
+            link().sendFrame(frame);
+
+            ConfigsPending = 0; // Configs are synchronized with real sensor.
+            return;
+        }
+
+        std::string configRequest = "?CONFIG&";
+        configRequest.reserve(CONFIG_BATCH_SIZE);
+        appendPendingConfigs(configRequest, std::string::npos);
+        link().sendMessage(configRequest);
+
+        ConfigsPending = 0; // Configs are synchronized with real sensor.
+    }
+
+    void syncValues()
+    {
+        isValuesSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
+        unsigned long start = getMillis();
+        if(isBinaryProtocol() && WireID >= 0)
+        {
+            link().sendFrame(BinaryFrameWriter(ProtocolCommand::UPDATE, (uint8_t)WireID).finish());
+            std::string_view response;
+            BinaryFrame frame;
+            //Only applied response is success, timeout and invalid values are failures
+            if(link().receiveFrame(response, timeout()) && decodeFrame(response, frame) &&
+               frame.Command == ProtocolCommand::UPDATE && frame.SensorID == (uint8_t)WireID && applyValues(frame))
+            {
+                recordSuccess(getMillis() - start);
+            }
+            else
+            {
+                recordFailure(getMillis());
+            }
+            return;
+        }
+
+        //Request buffer is reused (one per thread, links are synchronized by parallel workers)
+        static thread_local std::string updateRequest;
+        updateRequest.assign("?UPDATE&id=").append(UID);
+
+        //Start update sync process, adaptive timeout, so unreachable sensor does not stall the loop for UART_TIMEOUT
+        link().sendMessage(updateRequest);
+        std::string_view response;
+        if(!link().receiveFrame(response, timeout()))
+        {
+            response = std::string_view();
+        }
+
+        //Response is single record or batched response (?seq=..?id=..&..), record of this sensor is applied in place
+        while(!response.empty())
+        {
+            if(response[0] == '?')
+            {
+                response.remove_prefix(1);
+            }
+            size_t end = response.find('?');
+            SensorRecord record = ParseRecord(response.substr(0, end));
+            if(CheckRecord(record) && matches(record.ID, record.UID))
+            {
+                //Only applied record is success, invalid values are failure (reported by applyValues())
+                if(applyValues(record))
+                {
+                    recordSuccess(getMillis() - start);
+                    return;
+                }
+                break;
+            }
+            response = (end == std::string_view::npos) ? std::string_view() : response.substr(end);
+        }
+        recordFailure(getMillis()); // Timeout, no record of this sensor or invalid values
+    }
+
+public:
+    std::string UID;                ///< Unique sensor identifier.
+    int ID;                         ///< Interned integer ID (see internSensorID()), -1 if UID is not interned.
+    int WireID;                     ///< Compact sensor ID of binary protocol (numerical UID), -1 if UID is not numerical.
+    SensorStatus Status;             ///< Sensor status.
+    const char* Type;       ///< Sensor type as text (shared by schema).
+    const char* Description;///< Description of the sensor (shared by schema).
+    SensorError Error;      ///< Last error (if any).
+    SensorBlock* Block = nullptr; ///< Heap block of sensor created by createSensors(), nullptr otherwise.
+
+    //lv_obj_t *ui_Container; ///< Pointer to the UI widgets container.
+
+    /**
+     * @brief Set sensor visibility on screen, UI of visible sensor is constructed lazily by redraw.
+     * 
+     * @param visible Flag if sensor is visible.
+     */
+    void setVisible(bool visible)
+    {
+        if(visible && !isVisible)
+        {
+            redrawPenging = true; // Hidden sensor may have missed changes.
+        }
+        isVisible = visible;
+    }
+
+    /**
+     * @brief Check if sensor is visible on screen.
+     */
+    bool getVisible() const
+    {
+        return isVisible;
+    }
+
+    /**
+     * @brief Check if sensor needs to be drawn (visible and not constructed or redraw pending).
+     */
+    bool needsDraw() const
+    {
+        return isVisible && (!isConstructed || redrawPenging);
+    }
+
+    /**
+     * @brief Construct UI elements if not yet constructed, whole sensor is then redrawn.
+     * 
+     * @throws Exception if construction fails.
+     */
+    void ensureConstructed()
+    {
+        if(isConstructed)
+        {
+            return;
+        }
+
+        construct();
+        isConstructed = true;
+        redrawPenging = true;
+        for (auto &v : Values) {
+            v.Dirty = true;
+        }
+        for (auto &c : Configs) {
+            c.Dirty = true;
+        }
+    }
+
+    /**
+     * @brief Mark UI as not constructed (e.g. after screen change), it is constructed again when visible.
+     */
+    void resetConstruction()
+    {
+        isConstructed = false;
+    }
+    /**
+     * @brief Equality operator for comparing sensors by UID.
+     * 
+     * @param sensor The sensor to compare with.
+     * @return true if the sensors have the same UID, false otherwise.
+     */
+    bool operator==(const BaseSensor &sensor) const {
+        return UID == sensor.UID;
+    }
+
+    /**
+     * @brief Equality operator for comparing sensors by UID.
+     * 
+     * @param uid The UID to compare with.
+     * @return true if the sensor's UID matches the given UID, false otherwise.
+     */
+    bool operator==(std::string_view uid) const {
+        return UID == uid;
+    }
+
+    /**
+     * @brief Equality operator for comparing sensors by interned integer ID.
+     * 
+     * @param id The integer ID to compare with.
+     * @return true if the sensor's ID matches the given ID, false otherwise.
+     */
+    bool operator==(int id) const {
+        return ID >= 0 && ID == id;
+    }
+
+    /**
+     * @brief Check if sensor record belongs to the sensor, interned IDs are compared as integers.
+     * 
+     * @param id The interned ID of record (-1 if not interned).
+     * @param uid The UID of record.
+     */
+    bool matches(int id, std::string_view uid) const {
+        #ifdef SENSOR_INTERNED_IDS
+            if(ID >= 0 || id >= 0) {
+                return ID == id;
+            }
+        #else
+            (void)id;
+        #endif
+        return UID == uid;
+    }
+
+    /**
+     * @brief Constructs a new BaseSensor object.
+     * 
+     * @param uid The unique sensor identifier.
+     */
+    BaseSensor(std::string uid) : UID(uid), ID(internSensorID(uid)), WireID(-1), Status(SensorStatus::OK), Type(""), Description("") 
+    {
+
+        int id;
+        if(parseNumber(UID, id) && std::to_string(id) == UID && id >= 0 && id < PROTOCOL_BROADCAST_ID)
+        {
+            WireID = id;
+        }
+
+        redrawPenging = true;
+        isValuesSync = false;
+    }
+
+    /**
+     * @brief Virtual destructor.
+     */
+    virtual ~BaseSensor() 
+    {
+    }
+
+    /**
+     * @brief Set sensor status.
+     * 
+     * This function sets the sensor status based on the given status string.
+     * 
+     * @param status The status string.
+     */
+    void setStatus(std::string_view status)
+    {
+        if( status.empty() )
+        {
+            return;
+        }
+
+        if(status == "1")
+        {
+            setStatus(1);
+        }
+        else if(status == "-1")
+        {
+            setStatus(-1);
+        }
+        else if(status == "0")
+        {
+            setStatus(0);
+        }
+    }
+
+    /**
+     * @brief Set sensor status.
+     * 
+     * This function sets the sensor status based on the given numerical status (as SensorStatus).
+     * 
+     * @param status The numerical status, unknown status is ignored.
+     */
+    void setStatus(int status)
+    {
+        SensorStatus previous = Status;
+        switch (status)
+        {
+        case (int)SensorStatus::OK:
+            Status = SensorStatus::OK;
+            break;
+        case (int)SensorStatus::ERROR:
+            Status = SensorStatus::ERROR;
+            break;
+        case (int)SensorStatus::OFFLINE:
+            Status = SensorStatus::OFFLINE;
+            break;
+        default:
+            break;
+        }
+
+        redrawPenging |= (Status != previous); // Redraw only if status changed.
+        Changes += (Status != previous);
+    }
+
+    /**
+     * @brief Check if sensor needs to be redrawn.
+     * 
+     * @return true if some value, config or status changed since last draw.
+     */
+    bool isRedrawPending() const
+    {
+        return redrawPenging;
+    }
+
+    /**
+     * @brief Get number of changes applied by updates, callers compare it to detect change (e.g. poll backoff).
+     * 
+     * Unlike isRedrawPending(), it does not depend on drawing of the sensor.
+     */
+    uint32_t getChangeCount() const
+    {
+        return Changes;
+    }
+
+    /**
+     * @brief Check if value changed since last draw.
+     * 
+     * @param key The key of the value parameter.
+     * @return true if value changed, false otherwise (or if not found).
+     */
+    bool isValueDirty(const std::string &key) const
+    {
+        const SensorParam *param = findParameter(Values, key);
+        return param != nullptr && param->Dirty;
+    }
+
+    /**
+     * @brief Get link to the real sensor.
+     * 
+     * @return The assigned messenger or the default messenger.
+     */
+    Messenger& link() const
+    {
+        return Link != nullptr ? *Link : getDefaultMessenger();
+    }
+
+    /**
+     * @brief Assign link to the real sensor (e.g. sensor is connected to another UART).
+     * 
+     * @param link The messenger, must outlive the sensor, nullptr for default messenger.
+     */
+    void setLink(Messenger *link)
+    {
+        Link = link;
+    }
+
+    /**
+     * @brief Get adaptive timeout of update request (measured round trip of sensor, or of its link).
+     */
+    unsigned long timeout() const
+    {
+        return RoundTrip.hasSample() ? RoundTrip.timeout() : link().timeout();
+    }
+
+    /**
+     * @brief Record answered (and applied) update request, circuit of OFFLINE sensor is closed.
+     * 
+     * @param rtt The round trip in milliseconds.
+     */
+    void recordSuccess(unsigned long rtt)
+    {
+        RoundTrip.record(rtt);
+        link().recordRoundTrip(rtt);
+        closeCircuit();
+    }
+
+    /**
+     * @brief Record that sensor answered by valid update (any response path), circuit of OFFLINE sensor is closed.
+     */
+    void closeCircuit()
+    {
+        Failures = 0;
+        if(CircuitOpen)
+        {
+            CircuitOpen = false;
+            ProbeBackoff = 0;
+            if(Status == SensorStatus::OFFLINE)
+            {
+                setStatus((int)SensorStatus::OK);
+            }
+            LOG_INFO("Sensor %s is reachable again.\n", UID.c_str());
+        }
+    }
+
+    /**
+     * @brief Record failed (timed out, not answered or invalid) update request, sensor is marked OFFLINE after SENSOR_MAX_FAILURES.
+     * 
+     * Response with invalid values is a failure too, sensor returning garbage is not healthy.
+     * 
+     * @param now The current time in milliseconds.
+     * @return true if circuit was opened by this failure.
+     */
+    bool recordFailure(unsigned long now)
+    {
+        RoundTrip.recordTimeout();
+        link().recordTimeout();
+        if(Failures < 0xFF)
+        {
+            Failures++;
+        }
+        if(CircuitOpen)
+        {
+            //Failed probe, next one is later
+            if(ProbeBackoff < SENSOR_PROBE_MAX_BACKOFF)
+            {
+                ProbeBackoff++;
+            }
+            ProbeAt = now + ((unsigned long)SENSOR_PROBE_INTERVAL << ProbeBackoff);
+            return false;
+        }
+        if(Failures < SENSOR_MAX_FAILURES)
+        {
+            return false;
+        }
+
+        LOG_WARNING("Sensor %s is not responding, marked OFFLINE!\n", UID.c_str());
+        CircuitOpen = true;
+        ProbeBackoff = 0;
+        ProbeAt = now + SENSOR_PROBE_INTERVAL;
+        setStatus((int)SensorStatus::OFFLINE);
+        return true;
+    }
+
+    /**
+     * @brief Check if sensor is OFFLINE by circuit breaker (only background probes are sent).
+     */
+    bool isCircuitOpen() const
+    {
+        return CircuitOpen;
+    }
+
+    /**
+     * @brief Check if probe of OFFLINE sensor is due.
+     * 
+     * @param now The current time in milliseconds.
+     */
+    bool isProbeDue(unsigned long now) const
+    {
+        return CircuitOpen && (long)(now - ProbeAt) >= 0;
+    }
+
+    /**
+     * @brief Start probe of OFFLINE sensor, next probe is scheduled (probes do not run in parallel).
+     * 
+     * @param now The current time in milliseconds.
+     */
+    void beginProbe(unsigned long now)
+    {
+        ProbeAt = now + ((unsigned long)SENSOR_PROBE_INTERVAL << ProbeBackoff);
+    }
+
+    /**
+     * @brief Compile alarm rules of values, replaces previous rules (see alarms.hpp for rule text).
+     * 
+     * @param rules The rules joined by '&' (e.g. "temperature>30~0.5!&humidity<20&temperature/s>2"), empty to remove alarms.
+     * @return SUCCESS, VALUE_NOT_FOUND if key is not numerical value or INVALID_VALUE if rule is not valid (no rule is set).
+     */
+    ErrorCode setAlarms(std::string_view rules)
+    {
+        AlarmTable table;
+        while(!rules.empty())
+        {
+            size_t end = rules.find('&');
+            AlarmRule rule;
+            std::string_view key;
+            ErrorCode code = compileAlarmRule(rules.substr(0, end), rule, key);
+            if(code != ErrorCode::SUCCESS)
+            {
+                return code;
+            }
+            const SensorParam *param = findParameter(Values, key);
+            if(param == nullptr || param->type() == ::DataType::STRING)
+            {
+                return ErrorCode::VALUE_NOT_FOUND;
+            }
+            rule.Slot = (uint8_t)(param - Values.data());
+            table.add(rule);
+            rules = (end == std::string_view::npos) ? std::string_view() : rules.substr(end + 1);
+        }
+        Alarms = std::move(table);
+        return ErrorCode::SUCCESS;
+    }
+
+    /**
+     * @brief Set callback of raised and cleared alarms.
+     * 
+     * @param callback The callback, nullptr to remove it.
+     * @param context The context passed to callback.
+     */
+    void setAlarmCallback(AlarmCallback callback, void *context = nullptr)
+    {
+        OnAlarm = callback;
+        AlarmContext = context;
+    }
+
+    /**
+     * @brief Get compiled alarm rules with their state (e.g. to list active alarms).
+     */
+    const AlarmTable& getAlarms() const
+    {
+        return Alarms;
+    }
+
+    /**
+     * @brief Set time for which synchronized values are served from cache (see SensorManager::sync()).
+     * 
+     * @param ttl The freshness in milliseconds, 0 to always synchronize.
+     */
+    void setFreshTTL(unsigned long ttl)
+    {
+        FreshTTL = ttl;
+    }
+
+    /**
+     * @brief Get time for which synchronized values are fresh in milliseconds.
+     */
+    unsigned long getFreshTTL() const
+    {
+        return FreshTTL;
+    }
+
+    /**
+     * @brief Get time of last applied update in milliseconds.
+     */
+    unsigned long getUpdatedAt() const
+    {
+        return UpdatedAt;
+    }
+
+    /**
+     * @brief Check if values are synchronized, younger than freshness TTL and no config waits for sending.
+     * 
+     * @param now The current time in milliseconds.
+     */
+    bool isFresh(unsigned long now) const
+    {
+        return FreshTTL > 0 && isValuesSync && ConfigsPending == 0 && (now - UpdatedAt) < FreshTTL;
+    }
+
+    /**
+     * @brief Publish snapshot of current state for readers on other cores/threads.
+     * 
+     * Has to be called only by the task owning updates (single writer), it is done after every applied update.
+     */
+    void publish()
+    {
+        SensorSnapshot snapshot = {};
+        snapshot.Status = Status;
+        snapshot.Error = Error.Active;
+        snapshot.Time = getMillis();
+        snapshot.ValuesCount = (uint8_t)((Values.size() < SENSOR_SNAPSHOT_VALUES) ? Values.size() : SENSOR_SNAPSHOT_VALUES);
+        for (size_t i = 0; i < snapshot.ValuesCount; i++)
+        {
+            snapshot.Values[i] = (Values[i].type() != ::DataType::STRING) ? Values[i].as<double>() : NAN;
+        }
+        Snapshot.store(snapshot);
+    }
+
+    /**
+     * @brief Read last published snapshot, lock-free and safe from any core/thread.
+     * 
+     * @param snapshot The output snapshot.
+     * @return true if consistent snapshot was read, false if nothing was published yet or writer was too busy.
+     */
+    bool readSnapshot(SensorSnapshot &snapshot) const
+    {
+        return Snapshot.version() != 0 && Snapshot.load(snapshot);
+    }
+
+    /**
+     * @brief Get number of published snapshots, readers can compare it to detect change (e.g. to redraw).
+     */
+    uint32_t getSnapshotVersion() const
+    {
+        return Snapshot.version();
+    }
+
+    /**
+     * @brief Get runtime metrics of the sensor (recorded only with METRICS).
+     */
+    const SensorStats& getStats() const
+    {
+        return Stats;
+    }
+
+    /**
+     * @brief Record request round trip of the sensor.
+     * 
+     * @param millis The round trip in milliseconds.
+     */
+    void recordLatency(unsigned long millis)
+    {
+        Stats.Latency = (uint32_t)millis;
+        Stats.MaxLatency = (Stats.Latency > Stats.MaxLatency) ? Stats.Latency : Stats.MaxLatency;
+    }
+
+    /**
+     * @brief Reset runtime metrics of the sensor.
+     */
+    void resetStats()
+    {
+        Stats = SensorStats();
+    }
+
+    /**
+     * @brief Append runtime metrics as "id=UID&updates=..&errors=..&update_us=..&latency=..&latency_max=..".
+     * 
+     * @param out The message.
+     */
+    void appendStats(std::string &out) const
+    {
+        out += "id=";
+        out += UID;
+        out += "&updates=";
+        out += std::to_string(Stats.Updates);
+        out += "&errors=";
+        out += std::to_string(Stats.Errors);
+        out += "&update_us=";
+        out += std::to_string(Stats.UpdateTime);
+        out += "&latency=";
+        out += std::to_string(Stats.Latency);
+        out += "&latency_max=";
+        out += std::to_string(Stats.MaxLatency);
+    }
+
+    /**
+     * @brief Enable sample history of numerical value.
+     * 
+     * History is allocated once with fixed capacity (SENSOR_HISTORY_SIZE), every received sample
+     * is then recorded by update with O(1) statistics.
+     * 
+     * @param key The key of the value parameter.
+     * @return true if history is enabled, false if value is not found or not numerical.
+     */
+    bool enableHistory(std::string_view key)
+    {
+        SensorParam *param = findParameter(Values, key);
+        if(param == nullptr || param->type() == ::DataType::STRING)
+        {
+            return false;
+        }
+        if(!param->History)
+        {
+            param->History.reset(new ValueHistory(SENSOR_HISTORY_EMA_ALPHA));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get sample history of value, e.g. for chart (see ValueHistory::view()).
+     * 
+     * @param key The key of the value parameter.
+     * @return Pointer to the history or nullptr if history is not enabled.
+     */
+    const ValueHistory* getHistory(std::string_view key) const
+    {
+        const SensorParam *param = findParameter(Values, key);
+        return param != nullptr ? param->History.get() : nullptr;
+    }
+
+    /**
+     * @brief Get value from configuration, without throwing.
+     * 
+     * @param key The key of the configuration parameter.
+     * @param value The output value, untouched on failure.
+     * @return SUCCESS, VALUE_NOT_FOUND if key is unknown (or has no value) or INVALID_VALUE if value is not convertible to T.
+     */
+    template <typename T>
+    ErrorCode tryGetConfig(std::string_view key, T &value) const {
+        return tryGetParameter(Configs, key, value);
+    }
+
+    /**
+     * @brief Get value from configuration.
+     * 
+     * This function retrieves the value of a configuration parameter by key.
+     * 
+     * @param key The key of the configuration parameter.
+     * @return The value of the configuration parameter.
+     * @throws ConfigurationNotFoundException or InvalidDataTypeException, see tryGetConfig() for non-throwing variant.
+     */
+    template <typename T>
+    T getConfig(const std::string &key) {
+        T value{};
+        switch (tryGetConfig(key, value))
+        {
+        case ErrorCode::SUCCESS:
+            return value;
+        case ErrorCode::VALUE_NOT_FOUND:
+            throw ConfigurationNotFoundException("BaseSensor::getConfig", "Configuration not found for key: " + key);
+        default:
+            throw InvalidDataTypeException("BaseSensor::getConfig", "Configuration is not convertible for key: " + key);
+        }
+    }
+
+    /**
+     * @brief Set configuration value.
+     * 
+     * This function sets the value of a configuration parameter by key.
+     * 
+     * @param key The key of the configuration parameter.
+     * @param value The value to set.
+     */
+    void setConfig(const std::string &key, const std::string &value) {
+        SensorParam *param = findParameter(Configs, key);
+        if (param == nullptr) {
+            throw ConfigurationNotFoundException("BaseSensor::setConfig", "Configuration not found for key: " + key);
+        }
+        bool dirty = param->Dirty;
+        param->Dirty = false;
+        if (!param->assign(value)) {
+            param->Dirty = dirty;
+            throw InvalidDataTypeException("BaseSensor::setConfig", value + " is not valid value for key: " + key);
+        }
+        if (param->Dirty) {
+            ConfigsPending |= (uint32_t)1 << (param - Configs.data()); // Only changed config is not synchronized with real sensor.
+            onConfigChanged((size_t)(param - Configs.data()));
+        }
+        param->Dirty |= dirty;
+        redrawPenging |= param->Dirty; // Redraw only if value changed.
+    }
+
+    /**
+     * @brief Check if some config is not synchronized with real sensor.
+     * 
+     * @return true if some config was changed by setConfig() since last synchronization.
+     */
+    bool hasPendingConfigs() const {
+        return ConfigsPending != 0;
+    }
+
+    /**
+     * @brief Append not synchronized configs as "id=UID&key=value.." (text protocol).
+     * 
+     * @param out The message, nothing is appended if configs do not fit into limit.
+     * @param limit The maximal message size.
+     * @return true if configs were appended (or none is pending), false if they do not fit.
+     */
+    bool appendPendingConfigs(std::string &out, size_t limit) const {
+        if(ConfigsPending == 0) {
+            return true;
+        }
+        return appendConfigs(out, limit, ConfigsPending);
+    }
+
+    /**
+     * @brief Append all configs as "id=UID&key=value.." (e.g. for persisted topology).
+     * 
+     * @param out The output string.
+     */
+    void appendConfigs(std::string &out) const {
+        appendConfigs(out, std::string::npos, ~(uint32_t)0);
+    }
+
+    /**
+     * @brief Mark all configs as synchronized, e.g. after batched CONFIG message was sent.
+     */
+    void clearPendingConfigs() {
+        ConfigsPending = 0;
+    }
+
+    /**
+     * @brief Send not synchronized configs to the real sensor.
+     * 
+     * @throws Exception if synchronization fails.
+     */
+    void reconfigure() {
+        syncConfigs();
+    }
+
+    /**
+     * @brief Get value from sensor, without throwing.
+     * 
+     * @param key The key of the sensor parameter.
+     * @param value The output value, untouched on failure.
+     * @return SUCCESS, VALUE_NOT_FOUND if key is unknown (or has no value) or INVALID_VALUE if value is not convertible to T.
+     */
+    template <typename T>
+    ErrorCode tryGetValue(std::string_view key, T &value) const {
+        return tryGetParameter(Values, key, value);
+    }
+
+    /**
+     * @brief Get value from sensor.
+     * 
+     * This function retrieves the value of a sensor parameter by key.
+     * 
+     * @param key The key of the sensor parameter.
+     * @return The value of the sensor parameter.
+     * @throws ValueNotFoundException or InvalidDataTypeException, see tryGetValue() for non-throwing variant.
+     */
+    template <typename T>
+    T getValue(const std::string &key) {
+        T value{};
+        switch (tryGetValue(key, value))
+        {
+        case ErrorCode::SUCCESS:
+            return value;
+        case ErrorCode::VALUE_NOT_FOUND:
+            throw ValueNotFoundException("BaseSensor::getValue", "Value not found for key: " + key);
+        default:
+            throw InvalidDataTypeException("BaseSensor::getValue", "Value is not convertible for key: " + key);
+        }
+    }
+
+    /**
+     * @brief Set sensor value.
+     * 
+     * This function sets the value of a sensor parameter by key.
+     * 
+     * @param key The key of the sensor parameter.
+     * @param value The value to set.
+     */
+    void setValue(const std::string &key, const std::string &value) {
+        SensorParam *param = findParameter(Values, key);
+        if (param == nullptr) {
+            throw ValueNotFoundException("BaseSensor::setValue", "Value not found for key: " + key);
+        }
+        if (!param->assign(value)) {
+            throw InvalidDataTypeException("BaseSensor::setValue", value + " is not valid value for key: " + key);
+        }
+        redrawPenging |= param->Dirty; // Redraw only if value changed.
+    }
+
+    /**
+     * @brief Get units of sensor value parameter.
+     * 
+     * This function retrieves the units of a sensor value parameter by key.
      * 
      * @param key The key of the value sensor parameter.
      * @return The units of the value sensor parameter.
      */
-    std::string getValueUnits(const std::string &key) {
-        if (Values.find(key) != Values.end()) {
-            return Values[key].Unit;
+    std::string getValueUnits(const std::string &key) {
+        const SensorParam *param = findParameter(Values, key);
+        if (param != nullptr) {
+            return param->unit();
+        }
+        return "";
+    }
+
+    /**
+     * @brief Get units of sensor config parameter.
+     * 
+     * This function retrieves the units of a sensor config parameter by key.
+     * 
+     * @param key The key of the sensor config parameter.
+     * @return The units of the sensor config parameter.
+     */
+    std::string getConfigUnits(const std::string &key) {
+        const SensorParam *param = findParameter(Configs, key);
+        if (param != nullptr) {
+            return param->unit();
+        }
+        return "";
+    }
+
+    /**
+     * @brief Set exception as error and change status accordingly.
+     * 
+     * Exception is copied into inline error slot, no allocation is done.
+     * 
+     * @param error The exception as error.
+     */
+    void setError(const Exception &error) {
+        setError(error.Code, error.Source.c_str(), error.Message.c_str());
+    }
+
+    /**
+     * @brief Set error without exception and change status accordingly.
+     * 
+     * @param code The error code.
+     * @param source The error source.
+     * @param message The error message.
+     */
+    void setError(ErrorCode code, const char *source, const char *message) {
+        clearError();
+
+        Error.Active = true;
+        Error.Code = code;
+        snprintf(Error.Message, sizeof(Error.Message), "%s", message);
+        snprintf(Error.Source, sizeof(Error.Source), "%s", source);
+        if( Error.Code != ErrorCode::WARNING_CODE ) {
+            Status = SensorStatus::ERROR;
+        }
+    }
+
+    /**
+     * @brief Set exception as error and change status accordingly.
+     * 
+     * @param error The exception as error, ownership is taken (it is deleted), nullptr clears error.
+     */
+    void setError(Exception *error) {
+        if (error == nullptr) {
+            clearError();
+            return;
+        }
+
+        setError(*error);
+        delete error;
+    }
+
+    /**
+     * @brief Clear error and restore status.
+     */
+    void clearError() {
+        if (Error.Active) {
+            Error = SensorError();
+            Status = SensorStatus::OK;
         }
-        return "";
     }
 
     /**
-     * @brief Get units of sensor config parameter.
-     * 
-     * This function retrieves the units of a sensor config parameter by key.
+     * @brief Clear error of previous (e.g. invalid) update, once valid update is applied.
      * 
-     * @param key The key of the sensor config parameter.
-     * @return The units of the sensor config parameter.
+     * Recovery counts as change (see getChangeCount()), status of the update is applied after it.
      */
-    std::string getConfigUnits(const std::string &key) {
-        if (Configs.find(key) != Configs.end()) {
-            return Configs[key].Unit;
-        }
-        return "";
+    void recover() {
+        Changes += Error.Active;
+        clearError();
     }
 
     /**
-     * @brief Set exception as error and change status accordingly.
+     * @brief Check if sensor has error.
      * 
-     * @param error The exception as error.
+     * @return true if error is set.
      */
-    void setError(Exception *error) {
-        if (Error) {
-            delete Error;
-            Status = SensorStatus::OK;
-        }
-
-        Error = error;
-        if(Error)
-        {
-            if( Error->Code != ErrorCode::WARNING_CODE ) {
-                Status = SensorStatus::ERROR;
-            }
-        }
+    bool hasError() const {
+        return Error.Active;
     }
 
     /**
      * @brief Get error message.
      * 
-     * @return The error message.
+     * @return The error message (valid until error changes).
      */
-    std::string getError() const {
-        if(Error) {
-            return Error->Message;
+    const char* getError() const {
+        if(Error.Active) {
+            return Error.Message;
         }
         return "No error";
     }
@@ -376,8 +1816,19 @@ public:
      */
     virtual void synchronize()
     {
+        //OFFLINE sensor is only probed by backoff schedule
+        unsigned long now = getMillis();
+        if(CircuitOpen)
+        {
+            if(!isProbeDue(now))
+            {
+                return;
+            }
+            beginProbe(now);
+        }
+
         isValuesSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
-        if(!isConfigsSync)
+        if(ConfigsPending != 0)
         {
             try
             {
@@ -403,22 +1854,116 @@ public:
     }
 
     /**
-     * @brief Add configuration parameter to the sensor.
+     * @brief Apply received update response to the sensor.
      * 
-     * @param key The key of the configuration parameter.
-     * @param param The configuration parameter to add.
+     * Used by blocking syncValues() and by asynchronous resync, when response arrives.
+     * Invalid values are reported via setError(), no exception is thrown on this hot path.
+     * 
+     * @param metadata The parsed update response.
+     * @return true if response belongs to this sensor and was applied, false otherwise.
      */
-    void addConfigParameter(const std::string &key, const SensorParam &param) {
-        try
+    bool applyValues(const SensorMetadata &metadata)
+    {
+        SensorRecord record;
+        record.ID = metadata.ID;
+        record.UID = metadata.UID;
+        record.Status = metadata.Status;
+        record.Data = metadata.Data;
+        record.RequestID = metadata.RequestID;
+        record.Sequence = metadata.Sequence;
+        return applyValues(record);
+    }
+
+    /**
+     * @brief Apply sensor record of (streamed) update response to the sensor, without allocation.
+     * 
+     * @param record The parsed record.
+     * @return true if record belongs to this sensor and was applied, false otherwise.
+     */
+    bool applyValues(const SensorRecord &record)
+    {
+        if( !CheckRecord(record) || !matches(record.ID, record.UID) )
         {
-            Configs[key] = param;
+            return false;
         }
-        catch(const std::exception& e)
+
+        if( tryUpdate(record.Data) != ErrorCode::SUCCESS )
+        {
+            LOG_WARNING("Invalid value in update of sensor %s!\n", UID.c_str());
+            setError(ErrorCode::INVALID_VALUE, "BaseSensor::applyValues", "Invalid value in update response.");
+            publish();
+            return false;
+        }
+        closeCircuit(); // Sensor answered by valid record (e.g. by batched resync), its status comes from the record
+        recover();
+        setStatus(record.Status);
+        applyAlarmStatus();
+
+        isValuesSync = true; // Set flag to indicate sensor is synchronized with real sensor.
+        UpdatedAt = getMillis();
+        publish();
+        return true;
+    }
+
+    /**
+     * @brief Apply received binary update response to the sensor.
+     * 
+     * @param frame The decoded update response.
+     * @return true if response belongs to this sensor and was applied, false otherwise (or on invalid value).
+     */
+    bool applyValues(const BinaryFrame &frame)
+    {
+        if( frame.Command != ProtocolCommand::UPDATE || WireID < 0 || frame.SensorID != (uint8_t)WireID )
         {
-            throw InvalidConfigurationException("BaseSensor::addConfigParameter", e.what());
+            return false;
         }
 
-        isConfigsSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
+        #ifdef METRICS
+            unsigned long start = getMicros();
+        #endif
+        BinaryParamReader reader(frame.Params);
+        BinaryParam param;
+        bool valid = true;
+        unsigned long now = getMillis();
+        while (reader.next(param)) {
+            if(param.Slot < Values.size()) {
+                bool dirty = Values[param.Slot].Dirty;
+                Values[param.Slot].Dirty = false;
+                if(Values[param.Slot].assign(param)) {
+                    Values[param.Slot].record(now);
+                    Changes += Values[param.Slot].Dirty;
+                    evaluateAlarms(param.Slot, Values[param.Slot], now);
+                    #ifdef RECORDER
+                        recordReading(param.Slot, Values[param.Slot], now);
+                    #endif
+                } else {
+                    valid = false;
+                }
+                Values[param.Slot].Dirty |= dirty;
+                redrawPenging |= Values[param.Slot].Dirty; // Redraw only if value changed.
+            }
+            else {
+                valid &= assignExtraValue(param.Slot - Values.size(), param) != ErrorCode::INVALID_VALUE;
+            }
+        }
+        #ifdef METRICS
+            recordUpdate(start, valid);
+        #endif
+        if(!valid) {
+            LOG_WARNING("Invalid value in binary frame of sensor %s!\n", UID.c_str());
+            setError(ErrorCode::INVALID_VALUE, "BaseSensor::applyValues", "Invalid value in binary frame.");
+            publish();
+            return false;
+        }
+        closeCircuit(); // Sensor answered by valid frame (e.g. by batched resync), its status comes from the frame
+        recover();
+        setStatus(frame.Status);
+        applyAlarmStatus();
+
+        isValuesSync = true; // Set flag to indicate sensor is synchronized with real sensor.
+        UpdatedAt = now;
+        publish();
+        return true;
     }
 
     /**
@@ -429,73 +1974,87 @@ public:
      */
     virtual void config(const std::string &cfg)
     {
-        std::string value;
-        // Parse the config string and update the sensor configs.
-        for (auto &c : Configs) {
-            value = getValueFromKeyValueLikeString(cfg, c.first, '&');
-            if(!value.empty()) {
-                c.second.Value = value;
-            }
+        if(tryConfig(cfg) != ErrorCode::SUCCESS) {
+            throw InvalidConfigurationException("BaseSensor::config", "Invalid configuration value in: " + cfg);
         }
     }
 
     /**
-     * @brief Adds a value parameter to the sensor.
+     * @brief Configures the sensor with the given configuration string, without throwing.
      * 
-     * @param key The key of the value parameter.
-     * @param param The value parameter to add.
-     * @throws Exception if adding the value parameter fails.
+     * @param cfg The configuration string.
+     * @return SUCCESS or INVALID_VALUE if some configuration value is invalid (valid ones are applied).
      */
-    void addValueParameter(const std::string &key, const SensorParam &param) {
-        try
-        {
-            Values[key] = param;
-        }
-        catch(const std::exception& e)
-        {
-            throw InvalidValueException("BaseSensor::addValueParameter", new Exception(e));
-        }
-
-        isValuesSync = false; // Set flag to indicate sensor is not synchronized with real sensor.
+    ErrorCode tryConfig(std::string_view cfg)
+    {
+        // Parse the config string in single pass and update the sensor configs.
+        return assignParameters(Configs, cfg);
     }
 
     /**
      * @brief Updates the sensor with new data.
      * 
+     * Throwing wrapper of tryUpdate(), derived classes customize updates by overriding tryUpdate().
+     * 
      * @param update The update string containing new sensor data.
      * @throws Exception if update fails.
      */
-    virtual void update(const std::string &upd)
+    void update(const std::string &upd)
     {
-        std::string value;
-        // Parse the update string and update the sensor values.
-        for (auto &c : Values) {
-            value = getValueFromKeyValueLikeString(upd, c.first, '&');
-            if(!value.empty()) {
-                c.second.Value = value;
-            }
+        if(tryUpdate(upd) != ErrorCode::SUCCESS) {
+            throw InvalidValueException("BaseSensor::update", "Invalid value in: " + upd);
         }
     }
 
+    /**
+     * @brief Updates the sensor with new data, without throwing.
+     * 
+     * Every textual update (update(), applyValues() of synchronous and batched responses) goes through
+     * this function, so derived classes may override it to post-process values (call base first).
+     * 
+     * @param upd The update string containing new sensor data.
+     * @return SUCCESS or INVALID_VALUE if some value is invalid (valid ones are applied).
+     */
+    virtual ErrorCode tryUpdate(std::string_view upd)
+    {
+        #ifdef METRICS
+            unsigned long start = getMicros();
+        #endif
+        // Parse the update string in single pass and update the sensor values.
+        ErrorCode code = assignParameters(Values, upd);
+        #ifdef METRICS
+            recordUpdate(start, code == ErrorCode::SUCCESS);
+        #endif
+        return code;
+    }
+
     /**
      * @brief Prints sensor information.
      * @throws Exception if print fails.
      */
-    void print() const {
+    virtual void print() const {
         try
         {
             logMessage("Sensor UID: %s\n", UID.c_str());
-            logMessage("\tSensor Type: %s\n", Type.c_str());
-            logMessage("\tSensor Description: %s\n", Description.c_str());
+            logMessage("\tSensor Type: %s\n", Type);
+            logMessage("\tSensor Description: %s\n", Description);
             logMessage("\tSensor Status: %d\n", Status);
-            logMessage("\tSensor Error: %s\n", getError().c_str());
+            logMessage("\tSensor Error: %s\n", getError());
+            char buffer[SENSOR_PARAM_TEXT_SIZE];
+            std::string_view text;
             logMessage("\tSensor Configurations:\n");
             for (auto &c : Configs) {
-                logMessage("\t\t%s: %s %s\n", c.first.c_str(), c.second.Value.c_str(), c.second.Unit.c_str());
+                text = c.format(buffer, sizeof(buffer));
+                logMessage("\t\t%s: %.*s %s\n", c.key(), (int)text.size(), text.data(), c.unit());
             }
             logMessage("\tSensor Values:\n");
             for (auto &v : Values) {
-                logMessage("\t\t%s: %s %s\n", v.first.c_str(), v.second.Value.c_str(), v.second.Unit.c_str());
+                text = v.format(buffer, sizeof(buffer));
+                logMessage("\t\t%s: %.*s %s\n", v.key(), (int)text.size(), text.data(), v.unit());
+                if (v.History) {
+                    const SampleStats &stats = v.History->stats();
+                    logMessage("\t\t\tmin: %g max: %g mean: %g ema: %g (%lu samples)\n", stats.Min, stats.Max, stats.Mean, stats.Ema, stats.Count);
+                }
             }
         }
         catch(const std::exception& e)
@@ -539,6 +2098,20 @@ public:
  */
 class ADC : public BaseSensor {
 public:
+    static constexpr const char* TypeTag = "ADC"; ///< Type tag used in sensor list.
+
+    static constexpr ParamSchema ConfigsSchema[] = {
+        {"resolution", "bits", DataType::INT, "12"},
+    };
+    static constexpr ParamSchema ValuesSchema[] = {
+        {"value", "", DataType::INT, "0"},
+    };
+    static constexpr SensorSchema Schema = {
+        TypeTag, "Analog to Digital Converter",
+        ConfigsSchema, sizeof(ConfigsSchema) / sizeof(ConfigsSchema[0]),
+        ValuesSchema, sizeof(ValuesSchema) / sizeof(ValuesSchema[0])
+    };
+
     /**
      * @brief Constructs a new ADC object.
      * 
@@ -565,16 +2138,10 @@ public:
      */
     virtual void init() override {
         // Additional initialization for sensor can be added here.
-        Type = "ADC";
-        Description = "Analog to Digital Converter";
-        Error = nullptr;
-
         try
         {
-            // Default configs
-            addConfigParameter("resolution", {"12", "bits", DataType::INT});
-            // Default values
-            addValueParameter("value", {"0", "", DataType::INT});
+            // Default configs and values
+            applySchema(Schema);
         }
         catch(const std::exception& e)
         {
@@ -595,10 +2162,12 @@ public:
         
         // Draw sensor
 
-        // Call draw function here
+        // Call draw function here (only labels of dirty parameters need update)
+        // e.g. forEachDirtyParameter(...) { lv_label_set_text(...) } invalidates only changed label areas
+        // Chart of value history reads samples in place via getHistory("value")->view()
         //TODO: Implement draw function
         
-        redrawPenging = false; // Reset flag to redraw sensor.
+        clearDirty(); // Reset flag to redraw sensor.
     }
 
     /**
@@ -625,6 +2194,21 @@ public:
  */
 class TH : public BaseSensor {
     public:
+        static constexpr const char* TypeTag = "TH"; ///< Type tag used in sensor list.
+
+        static constexpr ParamSchema ConfigsSchema[] = {
+            {"precision", "decimals", DataType::INT, "2"},
+        };
+        static constexpr ParamSchema ValuesSchema[] = {
+            {"temperature", "Celsia", DataType::FLOAT, "0"},
+            {"humidity", "%", DataType::INT, "0"},
+        };
+        static constexpr SensorSchema Schema = {
+            TypeTag, "Temperature & Humidity Sensor",
+            ConfigsSchema, sizeof(ConfigsSchema) / sizeof(ConfigsSchema[0]),
+            ValuesSchema, sizeof(ValuesSchema) / sizeof(ValuesSchema[0])
+        };
+
         /**
          * @brief Constructs a new TH object.
          * 
@@ -652,17 +2236,10 @@ class TH : public BaseSensor {
          */
         virtual void init() override {
             // Additional initialization for sensor can be added here.
-            Type = "TH";
-            Description = "Temperature & Humidity Sensor";
-            Error = nullptr;
-    
             try
             {
-                // Default configs
-                addConfigParameter("precision", {"2", "decimals", DataType::INT});
-                // Default values
-                addValueParameter("temperature", {"0", "Celsia", DataType::FLOAT});
-                addValueParameter("humidity", {"0", "%", DataType::INT});
+                // Default configs and values
+                applySchema(Schema);
             }
             catch(const std::exception& e)
             {
@@ -682,11 +2259,13 @@ class TH : public BaseSensor {
             }
             // Draw sensor
 
-            // Call draw function here
+            // Call draw function here (only labels of dirty parameters need update)
+            // e.g. forEachDirtyParameter(...) { lv_label_set_text(...) } invalidates only changed label areas
+            // Chart of value history reads samples in place via getHistory("temperature")->view()
             //TODO: Implement draw function
 
             
-            redrawPenging = false; // Reset flag to redraw sensor.
+            clearDirty(); // Reset flag to redraw sensor.
         }
 
         /**
@@ -702,6 +2281,245 @@ class TH : public BaseSensor {
 };
 
 
+/**************************************************************************/
+
+/**
+ * @class MADC
+ * @brief Multi-channel ADC sensor class derived from BaseSensor.
+ * 
+ * Represents an ADC board with up to SENSOR_MAX_CHANNELS channels in one sensor object.
+ * Samples are stored in contiguous arrays and a whole frame of channels is accepted in one message:
+ * text "samples=v0,v1,..,vN" or binary INT parameters with slot = channel index.
+ * Raw samples are converted to volts (vref / (2^resolution - 1)) in batch, lazily on first read.
+ */
+class MADC : public BaseSensor {
+private:
+    int32_t Raw[SENSOR_MAX_CHANNELS] = {};                ///< Raw samples.
+    mutable float Scaled[SENSOR_MAX_CHANNELS] = {};       ///< Samples in volts.
+    mutable bool ScalePending = true;                     ///< Raw samples or configuration changed since last scaling.
+    uint32_t DirtyChannels = 0;                           ///< Bit mask of channels changed since last draw.
+
+    /**
+     * @brief Store raw sample of the channel.
+     */
+    void storeSample(size_t channel, int32_t sample) {
+        if(Raw[channel] != sample) {
+            Raw[channel] = sample;
+            DirtyChannels |= (uint32_t)1 << channel;
+            ScalePending = true;
+            redrawPenging = true; // Redraw only if value changed.
+            Changes++;
+        }
+    }
+
+    /**
+     * @brief Scale all raw samples in one batch, if needed.
+     */
+    void rescale() const {
+        if(!ScalePending) {
+            return;
+        }
+
+        int resolution = 12;
+        float vref = 3.3f;
+        tryGetConfig("resolution", resolution);
+        tryGetConfig("vref", vref);
+        float gain = (resolution > 0 && resolution < 32) ? vref / (float)((1u << resolution) - 1) : 0.0f;
+        scaleSamples(Raw, Scaled, channelCount(), gain);
+        ScalePending = false;
+    }
+
+protected:
+    /**
+     * @brief Changed configuration (vref, resolution, channels) invalidates scaling, samples are rescaled on next read.
+     */
+    virtual void onConfigChanged(size_t slot) override {
+        (void)slot;
+        ScalePending = true;
+    }
+
+    /**
+     * @brief Assign frame of channel samples "v0,v1,..,vN" (channels over count are ignored).
+     */
+    virtual ErrorCode assignExtraValue(std::string_view key, std::string_view value) override {
+        if(!equalsIgnoreCase(key, "samples")) {
+            return ErrorCode::VALUE_NOT_FOUND;
+        }
+
+        KeyValueTokenizer tokenizer(value, ',');
+        KeyValuePair sample;
+        size_t count = channelCount();
+        bool valid = true;
+        for (size_t channel = 0; channel < count && tokenizer.next(sample); channel++) {
+            int number;
+            if(parseNumber(sample.Key, number)) {
+                storeSample(channel, number);
+            } else {
+                valid = false;
+            }
+        }
+        return valid ? ErrorCode::SUCCESS : ErrorCode::INVALID_VALUE;
+    }
+
+    /**
+     * @brief Assign binary channel sample (slot is channel index).
+     */
+    virtual ErrorCode assignExtraValue(size_t slot, const BinaryParam &param) override {
+        if(slot >= channelCount()) {
+            return ErrorCode::VALUE_NOT_FOUND;
+        }
+        if(param.Type != ProtocolType::INT) {
+            return ErrorCode::INVALID_VALUE;
+        }
+
+        storeSample(slot, param.Number.Int);
+        return ErrorCode::SUCCESS;
+    }
+
+public:
+    static constexpr const char* TypeTag = "MADC"; ///< Type tag used in sensor list.
+
+    static constexpr ParamSchema ConfigsSchema[] = {
+        {"channels", "", DataType::INT, "16"},
+        {"resolution", "bits", DataType::INT, "12"},
+        {"vref", "V", DataType::FLOAT, "3.3"},
+    };
+    static constexpr SensorSchema Schema = {
+        TypeTag, "Multi-channel Analog to Digital Converter",
+        ConfigsSchema, sizeof(ConfigsSchema) / sizeof(ConfigsSchema[0]),
+        nullptr, 0 // Channel samples are stored in arrays, not as parameters
+    };
+
+    /**
+     * @brief Constructs a new MADC object.
+     * 
+     * Initializes default values and sets the sensor type and description.
+     * 
+     * @param uid The unique sensor identifier.
+     */
+    MADC(std::string uid) : BaseSensor(uid)
+    {
+        init();
+    }
+
+    /**
+     * @brief Virtual destructor.
+     */
+    virtual ~MADC() {}
+
+    /**
+     * @brief Initializes the sensor.
+     * 
+     * @throws Exception if initialization fails.
+     */
+    virtual void init() override {
+        try
+        {
+            // Default configs and values
+            applySchema(Schema);
+        }
+        catch(const std::exception& e)
+        {
+            throw;
+        }
+    }
+
+
+    /**
+     * @brief Get number of used channels.
+     */
+    size_t channelCount() const {
+        int channels = 0;
+        tryGetConfig("channels", channels);
+        if(channels < 0) {
+            return 0;
+        }
+        return (size_t)channels < SENSOR_MAX_CHANNELS ? (size_t)channels : SENSOR_MAX_CHANNELS;
+    }
+
+    /**
+     * @brief Get raw sample of the channel.
+     * 
+     * @param channel The channel index.
+     * @return The raw sample, 0 for unknown channel.
+     */
+    int32_t getRaw(size_t channel) const {
+        return channel < channelCount() ? Raw[channel] : 0;
+    }
+
+    /**
+     * @brief Get sample of the channel in volts.
+     * 
+     * @param channel The channel index.
+     * @return The sample in volts, 0 for unknown channel.
+     */
+    float getVoltage(size_t channel) const {
+        if(channel >= channelCount()) {
+            return 0.0f;
+        }
+        rescale();
+        return Scaled[channel];
+    }
+
+    /**
+     * @brief Get all channels in volts (channelCount() samples).
+     */
+    const float* getVoltages() const {
+        rescale();
+        return Scaled;
+    }
+
+    /**
+     * @brief Check if channel changed since last draw.
+     */
+    bool isChannelDirty(size_t channel) const {
+        return channel < SENSOR_MAX_CHANNELS && (DirtyChannels & ((uint32_t)1 << channel)) != 0;
+    }
+
+    /**
+     * @brief Prints sensor information including channel samples.
+     */
+    virtual void print() const override {
+        BaseSensor::print();
+
+        const float *voltages = getVoltages();
+        logMessage("\tSensor Channels:\n");
+        for (size_t i = 0; i < channelCount(); i++) {
+            logMessage("\t\t%u: %ld (%.3f V)\n", (unsigned)i, (long)Raw[i], voltages[i]);
+        }
+    }
+
+    /**
+     * @brief Draw sensor.
+     * 
+     * This function draws the sensor.
+     */
+    virtual void draw() override {
+        if (!redrawPenging)
+        {
+            return;
+        }
+        // Draw sensor
+
+        // Call draw function here (only labels of dirty channels need update)
+        //TODO: Implement draw function
+
+        DirtyChannels = 0;
+        clearDirty(); // Reset flag to redraw sensor.
+    }
+
+    /**
+     * @brief Construct UI elements.
+     * 
+     * This function constructs the sensor-specific GUI.
+     */
+    virtual void construct() override {
+        // Construct sensor UI
+
+        // Call construct LVGL functions here
+    }
+};
+
 /**************************************************************************/
 // CREATE FUNCTIONS
 /**************************************************************************/
@@ -709,32 +2527,125 @@ class TH : public BaseSensor {
 /**
  * @brief Factory function template to create a sensor of type T.
  * 
- * This function creates a sensor object of type T (which must have a constructor taking an int)
- * and returns a pointer to the newly created object. If initialization fails, it logs the error,
- * deletes the partially constructed object, and rethrows the exception.
+ * This function creates a sensor object of type T (which must have a constructor taking an uid)
+ * and returns a pointer to the newly created object. Sensor is placed into arena if given (and not full),
+ * otherwise it is allocated on heap. If initialization fails, it logs the error,
+ * releases the partially constructed object, and rethrows the exception.
  * 
  * @tparam T The sensor type, which must be derived from BaseSensor.
  * @param uid The unique sensor identifier.
+ * @param arena The arena for sensor (optional), sensor has to be released by destroySensor().
  * @return T* Pointer to the newly created sensor.
  * @throws SensorInitializationFailException if sensor initialization fails.
  */
 template<typename T>
-T* createSensor(std::string uid) {
+T* createSensor(std::string uid, MemoryArena *arena = nullptr) {
     static_assert(std::is_base_of<BaseSensor, T>::value, "T must be derived from BaseSensor");
     
     T* sensor = nullptr;
+    size_t mark = arena ? arena->used() : 0;
+    void *memory = arena ? arena->allocate(sizeof(T), alignof(T)) : nullptr;
     try {
-        sensor = new T(uid);
+        sensor = memory ? new (memory) T(uid) : new T(uid);
     } catch (const std::exception &ex) {
-        logMessage("Error during sensor initialization: %s\n", ex.what());
-        delete sensor;
+        LOG_ERROR("Error during sensor initialization: %s\n", ex.what());
+        if (memory) {
+            arena->rewind(mark);
+        }
         throw SensorInitializationFailException("createSensor", "Error during sensor initialization.", new Exception(ex));
     }
 
-    logMessage("Sensor [%s]:%s created successfully.\n", sensor->UID.c_str(), sensor->Type.c_str());
+    LOG_DEBUG("Sensor [%s]:%s created successfully.\n", sensor->UID.c_str(), sensor->Type);
     return sensor;
 }
 
+/**
+ * @brief Destroy sensor created by createSensor().
+ * 
+ * @param sensor The sensor to destroy.
+ * @param arena The arena used for creation (optional), arena memory is released by its reset().
+ */
+inline void destroySensor(BaseSensor *sensor, MemoryArena *arena = nullptr) {
+    if (sensor == nullptr) {
+        return;
+    }
+
+    if (sensor->Block != nullptr) {
+        SensorBlock *block = sensor->Block;
+        sensor->~BaseSensor();
+        if (--block->Live == 0) {
+            SensorBlock::release(block);
+        }
+    } else if (arena != nullptr && arena->owns(sensor)) {
+        sensor->~BaseSensor();
+    } else {
+        delete sensor;
+    }
+}
+
+/**
+ * @brief Factory function template to create block of sensors of type T (bulk construction of sensor list).
+ *
+ * Sensors are placed contiguously: into the arena if given (as many as fit), the rest into one heap block
+ * (see SensorBlock), nothing is logged per sensor. If initialization of some sensor fails, already created
+ * sensors are released and the exception is rethrown.
+ *
+ * @tparam T The sensor type, which must be derived from BaseSensor.
+ * @param uids The unique sensor identifiers.
+ * @param count The number of sensors.
+ * @param sensors The output sensors (count items), sensors have to be released by destroySensor().
+ * @param arena The arena for sensors (optional).
+ * @return Number of created sensors (count).
+ * @throws SensorInitializationFailException if sensor initialization fails.
+ */
+template<typename T>
+size_t createSensors(const std::string_view *uids, size_t count, BaseSensor **sensors, MemoryArena *arena = nullptr) {
+    static_assert(std::is_base_of<BaseSensor, T>::value, "T must be derived from BaseSensor");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "T must not be over-aligned");
+
+    size_t mark = arena ? arena->used() : 0;
+    size_t fitting = arena ? arena->available(alignof(T)) / sizeof(T) : 0;
+    size_t pooled = (fitting < count) ? fitting : count;
+    T* pool = (pooled > 0) ? (T*)arena->allocate(sizeof(T) * pooled, alignof(T)) : nullptr;
+    SensorBlock* block = (count > pooled) ? SensorBlock::allocate(sizeof(T), count - pooled) : nullptr;
+    size_t created = 0;
+    try {
+        for (; created < count; created++) {
+            std::string uid(uids[created]);
+            if (created < pooled) {
+                sensors[created] = new (pool + created) T(std::move(uid));
+                continue;
+            }
+            T* sensor = new (block->at(sizeof(T), created - pooled)) T(std::move(uid));
+            sensor->Block = block;
+            block->Live++;
+            sensors[created] = sensor;
+        }
+    } catch (const std::exception &ex) {
+        LOG_ERROR("Error during sensor initialization: %s\n", ex.what());
+        bool blockUsed = created > pooled;
+        for (size_t i = 0; i < created; i++) {
+            destroySensor(sensors[i], arena); // Block is released with its last sensor
+        }
+        if (block != nullptr && !blockUsed) {
+            SensorBlock::release(block);
+        }
+        if (pool != nullptr) {
+            arena->rewind(mark);
+        }
+        throw SensorInitializationFailException("createSensors", "Error during sensor initialization.", new Exception(ex));
+    }
+    return count;
+}
+
+/**************************************************************************/
+// SENSOR TYPES REGISTRATION
+/**************************************************************************/
+
+REGISTER_SENSOR_TYPE(ADC)
+REGISTER_SENSOR_TYPE(TH)
+REGISTER_SENSOR_TYPE(MADC)
+
  /**************************************************************************/
 // GENERAL FUNCTIONS
 /**************************************************************************/
@@ -763,6 +2674,30 @@ void configSensor(BaseSensor *sensor, const std::string &config);
  */
 void updateSensor(BaseSensor *sensor, const std::string &update);
 
+/**
+ * @brief Applies received update response to the sensor.
+ * 
+ * This function applies the parsed response by calling the sensor's applyValues() method.
+ * 
+ * @param sensor Pointer to the sensor to be updated.
+ * @param metadata The parsed update response.
+ * @return true if response was applied, false otherwise.
+ * @throws Exceptions should be internally resolved to prevent program from crash.
+ */
+bool applySensor(BaseSensor *sensor, const SensorMetadata &metadata);
+
+/**
+ * @brief Applies sensor record of (streamed) update response to the sensor.
+ * 
+ * @param sensor Pointer to the sensor to update.
+ * @param record The parsed record.
+ * @return true if record was applied, false otherwise.
+ */
+bool applySensor(BaseSensor *sensor, const SensorRecord &record);
+
+// Overload for binary update response
+bool applySensor(BaseSensor *sensor, const BinaryFrame &frame);
+
 /**
  * @brief Prints detailed information about the sensor.
  * 
@@ -784,6 +2719,16 @@ void printSensor(BaseSensor *sensor);
  */
 void syncSensor(BaseSensor *sensor);
 
+/**
+ * @brief Sends not synchronized configs to the real sensor.
+ * 
+ * This function calls the sensor's reconfigure() method.
+ * 
+ * @param sensor Pointer to the sensor to be reconfigured.
+ * @throws Exceptions should be internally resolved to prevent program from crash.
+ */
+void reconfigureSensor(BaseSensor *sensor);
+
 /**
  * @brief Draws the sensor.
  * 
@@ -797,7 +2742,7 @@ void drawSensor(BaseSensor *sensor);
 /**
  * @brief Constructs the sensor.
  * 
- * This function constructs the sensor by calling the sensor's construct() method.
+ * This function constructs the sensor UI by calling the sensor's ensureConstructed() method (only once).
  * 
  * @param sensor Pointer to the sensor to be constructed.
  * @throws Exceptions should be internally resolved to prevent program from crash.
@@ -0,0 +1,99 @@
+/*
+* Copyright 2025 MTA
+* Author: Ing. Jiri Konecny
+*/
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "topology.hpp"
+
+#ifdef ARDUINO_H
+    #include <Preferences.h> ///< ESP32 NVS storage
+#else
+    #include <cstdio>        ///< For fopen
+#endif
+
+#ifdef ARDUINO_H
+    /**********************
+     *     VARIABLES
+     **********************/
+    static const char *topologyKey = "topology"; ///< Key of topology in NVS.
+
+    bool NvsTopologyStore::load(std::string &data) {
+        Preferences preferences;
+        if (!preferences.begin(Namespace, true)) {
+            return false;
+        }
+        String stored = preferences.getString(topologyKey, "");
+        preferences.end();
+        data.assign(stored.c_str(), stored.length());
+        return !data.empty();
+    }
+
+    bool NvsTopologyStore::save(const std::string &data) {
+        Preferences preferences;
+        if (!preferences.begin(Namespace, false)) {
+            return false;
+        }
+        size_t written = preferences.putString(topologyKey, data.c_str());
+        preferences.end();
+        return written == data.size();
+    }
+
+    void NvsTopologyStore::clear() {
+        Preferences preferences;
+        if (preferences.begin(Namespace, false)) {
+            preferences.remove(topologyKey);
+            preferences.end();
+        }
+    }
+#else
+    bool FileTopologyStore::load(std::string &data) {
+        FILE *file = fopen(Path.c_str(), "rb");
+        if (file == nullptr) {
+            return false;
+        }
+        data.clear();
+        char buffer[256];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            data.append(buffer, count);
+        }
+        fclose(file);
+        return !data.empty();
+    }
+
+    bool FileTopologyStore::save(const std::string &data) {
+        // Write into temporary file and replace, so power loss does not leave broken topology
+        std::string temporary = Path + ".tmp";
+        FILE *file = fopen(temporary.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+        written &= fclose(file) == 0;
+        if (!written) {
+            remove(temporary.c_str());
+            return false;
+        }
+        #ifdef _WIN32
+            remove(Path.c_str()); // rename does not replace existing file on Windows
+        #endif
+        return rename(temporary.c_str(), Path.c_str()) == 0;
+    }
+
+    void FileTopologyStore::clear() {
+        remove(Path.c_str());
+    }
+#endif
+
+TopologyStore& getDefaultTopologyStore() {
+    // Constructed on first use, safe for static initializers
+    #ifdef ARDUINO_H
+        static NvsTopologyStore store;
+    #else
+        static FileTopologyStore store;
+    #endif
+    return store;
+}
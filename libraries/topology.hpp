@@ -0,0 +1,115 @@
+/**
+ * @file topology.hpp
+ * @brief Declaration of persisted sensor topology (sensors list and last configs) for fast startup.
+ *
+ * Topology is stored as text: first line is sensors list in ?INIT format (e.g. 0:ADC&1:ADC&2:TH),
+ * every following line holds configs of one sensor (e.g. id=0&resolution=10).
+ * It is stored in NVS on Arduino (ESP32 Preferences) or in file on Linux/PC.
+ *
+ * @copyright 2025 MTA
+ * @author Ing. Jiri Konecny
+ */
+
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "config.hpp"     ///< Configuration.
+#include "exceptions.hpp" ///< Exception handling.
+
+#include <string>
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef TOPOLOGY_FILE
+    #define TOPOLOGY_FILE "sensors.topology"
+#endif
+
+#ifndef TOPOLOGY_NVS_NAMESPACE
+    #define TOPOLOGY_NVS_NAMESPACE "sensors"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * @class TopologyStore
+ * @brief Persistent storage of sensor topology.
+ */
+class TopologyStore
+{
+public:
+    virtual ~TopologyStore() {}
+
+    /**
+     * @brief Load stored topology.
+     *
+     * @param data The output topology text.
+     * @return true if topology was loaded, false if nothing is stored.
+     */
+    virtual bool load(std::string &data) = 0;
+
+    /**
+     * @brief Store topology, replaces previous one.
+     *
+     * @param data The topology text.
+     * @return true if topology was stored, false otherwise.
+     */
+    virtual bool save(const std::string &data) = 0;
+
+    /**
+     * @brief Remove stored topology.
+     */
+    virtual void clear() = 0;
+};
+
+#ifdef ARDUINO_H
+    /**
+     * @class NvsTopologyStore
+     * @brief Topology stored in NVS (ESP32 Preferences).
+     */
+    class NvsTopologyStore : public TopologyStore
+    {
+    private:
+        const char *Namespace; ///< NVS namespace.
+    public:
+        explicit NvsTopologyStore(const char *ns = TOPOLOGY_NVS_NAMESPACE) : Namespace(ns) {}
+
+        bool load(std::string &data) override;
+        bool save(const std::string &data) override;
+        void clear() override;
+    };
+#else
+    /**
+     * @class FileTopologyStore
+     * @brief Topology stored in file.
+     */
+    class FileTopologyStore : public TopologyStore
+    {
+    private:
+        std::string Path; ///< File path.
+    public:
+        explicit FileTopologyStore(const std::string &path = TOPOLOGY_FILE) : Path(path) {}
+
+        bool load(std::string &data) override;
+        bool save(const std::string &data) override;
+        void clear() override;
+    };
+#endif
+
+/*********************
+ *      DECLARES
+ *********************/
+
+/**
+ * @brief Get the default topology store (NVS on Arduino, TOPOLOGY_FILE otherwise).
+ *
+ * @return The topology store.
+ */
+TopologyStore& getDefaultTopologyStore();
+
+#endif // TOPOLOGY_HPP
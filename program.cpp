@@ -11,6 +11,7 @@ int main() {
 
     std::string initRequest = "?0:ADC&1:ADC&2:TH";
 
+    //Manager.setTopologyStore(&getDefaultTopologyStore()); // restore cached sensors by init(true), see TOPOLOGY_CACHE
     //Manager.init();
     Manager.init(true);
     Manager.print();
@@ -19,6 +20,53 @@ int main() {
     Manager.resync();
     Manager.redraw();
 
+    /*
+    //Or resync asynchronously, main loop keeps running while waiting for responses
+    Manager.requestResync();
+    while(Manager.isSyncPending())
+    {
+        Manager.process();
+        Manager.redraw();
+    }
+    */
+
+    /*
+    //Sensors on another link are synchronized in parallel by resync()
+    SerialPortMessenger uart2("/dev/ttyUSB1", 115200);
+    uart2.init();
+    Manager.assignSensor("2", Manager.addLink(uart2));
+    Manager.resync();
+    */
+
+    /*
+    //Or poll sensors by schedule, fast channels often and slow ones rarely
+    Manager.setPollInterval("0", 100, 1);
+    Manager.setPollInterval("2", 10000);
+    while(true)
+    {
+        Manager.poll();
+        Manager.redraw();
+    }
+    */
+
+    /*
+    //On-demand reads, values fresh within SENSOR_FRESH_TTL are served from cache, refresh() always asks the sensor
+    Manager.sync("0");
+    Manager.sync("0");
+    Manager.refresh("0");
+    */
+
+    /*
+    //Alarms evaluated by updates (threshold with hysteresis, rate per second, '!' sets sensor status ERROR)
+    Manager.getSensor(std::string_view("2"))->setAlarms("temperature>30~0.5!&humidity<20&temperature/s>2");
+    */
+
+    /*
+    //Runtime metrics (send, receive, parse, update, draw, resync timers and per-sensor latency)
+    Manager.sendStats();
+    Manager.resetStats();
+    */
+
     Manager.print();
     Manager.erase();
 
@@ -49,17 +97,15 @@ int main() {
     th->synchronize();
 
     //How to get certain value from sensor
-    std::string tempValue = th->Values["Temperature"].Value;
-    std::string tempUnit = th->Values["Temperature"].Unit;
-    DataType tempDt = th->Values["Temperature"].DataType;
+    std::string tempValue = th->getValue<std::string>("temperature");
+    std::string tempUnit = th->getValueUnits("temperature");
 
-    std::string huminidyValue = th->Values["Humidity"].Value;
-    std::string huminidyUnit = th->Values["Humidity"].Unit;
-    DataType huminidyDt = th->Values["Humidity"].DataType;
+    std::string huminidyValue = th->getValue<std::string>("humidity");
+    std::string huminidyUnit = th->getValueUnits("humidity");
 
-    //How to convert string values to numerical values
-    double doubleTempValue = std::stod(tempValue);
-    int intHuminidyValue = std::stoi(huminidyValue);
+    //How to get numerical values (stored natively, no conversion)
+    double doubleTempValue = th->getValue<double>("temperature");
+    int intHuminidyValue = th->getValue<int>("humidity");
 
     printf("Temperature: %f [%s]\n", doubleTempValue, tempUnit.c_str());
     printf("Humidity: %d [%s]\n", intHuminidyValue, huminidyUnit.c_str());